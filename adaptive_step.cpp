@@ -0,0 +1,106 @@
+#include "adaptive_step.h"
+
+#include <algorithm>
+#include <math.h>
+
+using namespace chrono;
+
+static const char* eventNames[] = { "kept", "grown", "contact", "spring", "violation" };
+
+AdaptiveStepper::AdaptiveStepper(ChSystem& system, const AdaptiveStepSettings& settings)
+    : system(system), settings(settings) {
+    step = std::max(settings.minStep, std::min(settings.maxStep, settings.initialStep));
+    lastContacts = system.GetNcontacts();
+}
+
+void AdaptiveStepper::WatchSprings(const std::vector<std::shared_ptr<ChLinkSpring>>& watched) {
+    springs = watched;
+    springLength.resize(springs.size());
+    for (size_t s = 0; s < springs.size(); s++)
+        springLength[s] = springs[s]->Get_SpringLength();
+}
+
+//largest |C| over the bilateral link constraints
+double AdaptiveStepper::ConstraintViolation() {
+    double largest = 0;
+    for (const auto& link : system.Get_linklist()) {
+        ChMatrix<>* c = link->GetC();
+        if (c && c->GetRows() > 0)
+            largest = std::max(largest, c->NormInf());
+    }
+    return largest;
+}
+
+double AdaptiveStepper::Step() {
+    TakeStep(step);
+    return history.back().step;
+}
+
+void AdaptiveStepper::TakeStep(double taken) {
+    system.DoStepDynamics(taken);
+
+    AdaptiveStepEvent event = STEP_KEPT;
+
+    int contacts = system.GetNcontacts();
+    if (contacts - lastContacts > settings.maxNewContacts)
+        event = STEP_SHRUNK_CONTACT;
+    lastContacts = contacts;
+
+    double maxTravel = 0;
+    for (size_t s = 0; s < springs.size(); s++) {
+        double length = springs[s]->Get_SpringLength();
+        maxTravel = std::max(maxTravel, fabs(length - springLength[s]));
+        springLength[s] = length;
+    }
+    if (event == STEP_KEPT && maxTravel > settings.maxSpringTravel)
+        event = STEP_SHRUNK_SPRING;
+
+    if (event == STEP_KEPT && settings.maxViolation > 0 && ConstraintViolation() > settings.maxViolation)
+        event = STEP_SHRUNK_VIOLATION;
+
+    if (event != STEP_KEPT) {
+        step = std::max(settings.minStep, step * settings.shrinkFactor);
+        calmSteps = 0;
+    } else if (++calmSteps >= settings.calmStepsToGrow) {
+        if (step < settings.maxStep)
+            event = STEP_GROWN;
+        step = std::min(settings.maxStep, step * settings.growFactor);
+        calmSteps = 0;
+    }
+
+    history.push_back({ system.GetChTime(), taken, contacts, event });
+}
+
+void AdaptiveStepper::AdvanceTo(double endTime) {
+    while (system.GetChTime() < endTime - 0.5 * settings.minStep) {
+        //the last step is cut to land on endTime, the controller keeps adapting its own step size
+        TakeStep(std::min(step, endTime - system.GetChTime()));
+    }
+}
+
+void AdaptiveStepper::PrintSummary(std::ostream& out) const {
+    if (history.empty()) {
+        out << "ADAPTIVE STEP: no steps taken" << std::endl;
+        return;
+    }
+    double minTaken = history[0].step, maxTaken = history[0].step, total = 0;
+    long shrinks[3] = { 0, 0, 0 };
+    for (const auto& record : history) {
+        minTaken = std::min(minTaken, record.step);
+        maxTaken = std::max(maxTaken, record.step);
+        total += record.step;
+        if (record.event >= STEP_SHRUNK_CONTACT)
+            shrinks[record.event - STEP_SHRUNK_CONTACT]++;
+    }
+    out << "ADAPTIVE STEP: " << history.size() << " steps, step min " << minTaken << " max " << maxTaken << " mean "
+        << total / history.size() << " s" << std::endl;
+    out << "ADAPTIVE STEP SHRINKS: contact " << shrinks[0] << ", spring " << shrinks[1] << ", violation " << shrinks[2]
+        << std::endl;
+}
+
+void AdaptiveStepper::WriteHistoryCsv(std::ostream& out) const {
+    out << "time,step,contacts,event" << std::endl;
+    for (const auto& record : history)
+        out << record.time << ',' << record.step << ',' << record.contacts << ',' << eventNames[record.event] << '\n';
+    out.flush();
+}
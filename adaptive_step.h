@@ -0,0 +1,95 @@
+// =============================================================================
+// Adaptive time stepping around DoStepDynamics.
+//
+// The step grows while the rover rolls smoothly and shrinks as soon as one of
+// the watched signals says the motion got violent:
+//   - new contacts appeared (wheel hitting an obstacle, landing)
+//   - a spring moved more than maxSpringTravel in one step
+//   - the position constraint violation of a joint went above maxViolation
+//     (links only -> the contact rows, which hold the gap of every contact in
+//     the collision envelope, are not constraint errors)
+//
+// Steps are never rejected: the step that detects an event is kept and the
+// following steps are taken at the reduced size.
+// =============================================================================
+
+#ifndef ADAPTIVE_STEP_H
+#define ADAPTIVE_STEP_H
+
+#include "chrono/physics/ChSystem.h"
+#include "chrono/physics/ChLinkSpring.h"
+
+#include <memory>
+#include <ostream>
+#include <vector>
+
+struct AdaptiveStepSettings {
+    double minStep = 0.0002;
+    double maxStep = 0.004;
+    double initialStep = 0.001;
+
+    double growFactor = 1.25;          //applied after calmStepsToGrow steps without an event
+    double shrinkFactor = 0.5;         //applied on every event
+    int calmStepsToGrow = 20;
+
+    int maxNewContacts = 0;            //more new contacts than this in one step is an impact
+    double maxSpringTravel = 0.001;    //meters a spring may stretch or compress in one step
+    double maxViolation = 0.001;       //largest allowed position constraint residual of any link
+};
+
+//what made the controller change the step
+enum AdaptiveStepEvent {
+    STEP_KEPT = 0,
+    STEP_GROWN,
+    STEP_SHRUNK_CONTACT,
+    STEP_SHRUNK_SPRING,
+    STEP_SHRUNK_VIOLATION
+};
+
+struct AdaptiveStepRecord {
+    double time;   //sim time at the end of the step
+    double step;   //size of the step just taken
+    int contacts;
+    AdaptiveStepEvent event;
+};
+
+class AdaptiveStepper {
+  public:
+    AdaptiveStepper(chrono::ChSystem& system, const AdaptiveStepSettings& settings = AdaptiveStepSettings());
+
+    //springs whose travel per step is watched (e.g. RoverModel::springs)
+    void WatchSprings(const std::vector<std::shared_ptr<chrono::ChLinkSpring>>& springs);
+
+    //take one step of the current size, then pick the size of the next one. Returns the step taken.
+    double Step();
+
+    //step until the system time reaches endTime. The last step is cut so it lands on endTime.
+    void AdvanceTo(double endTime);
+
+    double CurrentStep() const { return step; }
+    long NumSteps() const { return (long)history.size(); }
+    const std::vector<AdaptiveStepRecord>& History() const { return history; }
+
+    //step count, smallest/largest/mean step and the number of shrink events
+    void PrintSummary(std::ostream& out) const;
+    //time,step,contacts,event -> one line per step
+    void WriteHistoryCsv(std::ostream& out) const;
+
+  private:
+    //step by `taken` and adapt the step size from what happened during it
+    void TakeStep(double taken);
+    double ConstraintViolation();
+
+    chrono::ChSystem& system;
+    AdaptiveStepSettings settings;
+    double step;
+    int calmSteps = 0;
+    int lastContacts = 0;
+
+    std::vector<std::shared_ptr<chrono::ChLinkSpring>> springs;
+    std::vector<double> springLength;
+
+    std::vector<AdaptiveStepRecord> history;
+};
+
+#endif
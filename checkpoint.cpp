@@ -0,0 +1,110 @@
+#include "checkpoint.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace chrono;
+
+//file layout: header, then x, v, a and reactions as raw doubles
+struct CheckpointHeader {
+    char magic[8];  //"ROVCKPT"
+    uint32_t version;
+    uint32_t numBodies;    //informational, fixed bodies are not part of the state
+    uint32_t numCoordsX;   //position level coordinates
+    uint32_t numCoordsW;   //velocity level coordinates
+    uint32_t numConstr;    //constraint reactions
+    uint32_t reserved;
+    double time;
+};
+
+static const char checkpointMagic[8] = "ROVCKPT";
+static const uint32_t checkpointVersion = 1;
+
+static void WriteVector(std::ofstream& out, const ChVectorDynamic<>& vector, int size) {
+    out.write((const char*)vector.GetAddress(), size * sizeof(double));
+}
+
+static bool ReadVector(std::ifstream& in, ChVectorDynamic<>& vector, int size) {
+    in.read((char*)vector.GetAddress(), size * sizeof(double));
+    return (bool)in;
+}
+
+bool SaveCheckpoint(ChSystem& system, const std::string& path) {
+    //make sure every item has its offsets in the state vectors
+    system.Setup();
+    system.Update();
+
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, checkpointMagic, sizeof(header.magic));
+    header.version = checkpointVersion;
+    header.numBodies = (uint32_t)system.Get_bodylist().size();
+    header.numCoordsX = system.GetNcoords_x();
+    header.numCoordsW = system.GetNcoords_w();
+    header.numConstr = system.GetNconstr();
+
+    ChState x(header.numCoordsX, &system);
+    ChStateDelta v(header.numCoordsW, &system);
+    ChStateDelta a(header.numCoordsW, &system);
+    ChVectorDynamic<> reactions(header.numConstr);
+    system.StateGather(x, v, header.time);
+    system.StateGatherAcceleration(a);
+    system.StateGatherReactions(reactions);
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        std::cerr << "Could not create checkpoint " << path << std::endl;
+        return false;
+    }
+    out.write((const char*)&header, sizeof(header));
+    WriteVector(out, x, header.numCoordsX);
+    WriteVector(out, v, header.numCoordsW);
+    WriteVector(out, a, header.numCoordsW);
+    WriteVector(out, reactions, header.numConstr);
+    if (!out) {
+        std::cerr << "Could not write checkpoint " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LoadCheckpoint(ChSystem& system, const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Could not open checkpoint " << path << std::endl;
+        return false;
+    }
+
+    CheckpointHeader header;
+    in.read((char*)&header, sizeof(header));
+    if (!in || memcmp(header.magic, checkpointMagic, sizeof(header.magic)) != 0 || header.version != checkpointVersion) {
+        std::cerr << path << " is not a checkpoint file" << std::endl;
+        return false;
+    }
+
+    system.Setup();
+    system.Update();
+    if ((int)header.numCoordsX != system.GetNcoords_x() || (int)header.numCoordsW != system.GetNcoords_w() ||
+        (int)header.numConstr != system.GetNconstr()) {
+        std::cerr << "Checkpoint " << path << " was saved from a different model (" << header.numBodies << " bodies, "
+                  << header.numCoordsX << " coordinates, " << header.numConstr << " constraints)" << std::endl;
+        return false;
+    }
+
+    ChState x(header.numCoordsX, &system);
+    ChStateDelta v(header.numCoordsW, &system);
+    ChStateDelta a(header.numCoordsW, &system);
+    ChVectorDynamic<> reactions(header.numConstr);
+    if (!ReadVector(in, x, header.numCoordsX) || !ReadVector(in, v, header.numCoordsW) ||
+        !ReadVector(in, a, header.numCoordsW) || !ReadVector(in, reactions, header.numConstr)) {
+        std::cerr << "Checkpoint " << path << " is truncated" << std::endl;
+        return false;
+    }
+
+    system.StateScatter(x, v, header.time);
+    system.StateScatterAcceleration(a);
+    system.StateScatterReactions(reactions);
+    return true;
+}
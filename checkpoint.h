@@ -0,0 +1,31 @@
+// =============================================================================
+// Full-state checkpoints.
+//
+// Saves the complete state of a system (positions and velocities of every
+// active body and link, accelerations, constraint reactions and time) to a
+// small binary file, and restores it into a freshly built copy of the same
+// model. Many scenarios can then fork from one settled pose instead of each
+// run dropping the rover and waiting for the springs to settle.
+//
+// The restored model has to be built the same way as the saved one (same
+// builders, same order). Fixed bodies such as the floor and obstacles are not
+// part of the state, so they can be moved between save and restore. Torques,
+// spring and damping coefficients are not state either and can be changed
+// freely; link geometry cannot.
+// =============================================================================
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "chrono/physics/ChSystem.h"
+
+#include <string>
+
+//write the current state of the system. Returns false if the file cannot be written.
+bool SaveCheckpoint(chrono::ChSystem& system, const std::string& path);
+
+//restore a state written by SaveCheckpoint. Returns false (and leaves the system untouched)
+//if the file cannot be read or was saved from a model with a different layout.
+bool LoadCheckpoint(chrono::ChSystem& system, const std::string& path);
+
+#endif
@@ -0,0 +1,91 @@
+#include "collision_stats.h"
+
+#include <algorithm>
+
+using namespace chrono;
+using namespace chrono::collision;
+
+class CollisionStats::BroadphaseCounter : public ChCollisionSystem::BroadphaseCallback {
+  public:
+    explicit BroadphaseCounter(CollisionStats& stats) : stats(stats) {}
+
+    virtual bool OnBroadphase(ChCollisionModel* modelA, ChCollisionModel* modelB) override {
+        stats.current.broadphasePairs++;
+        if (!stats.roverBodies.empty() && stats.roverBodies.count(modelA->GetContactable()) &&
+            stats.roverBodies.count(modelB->GetContactable()))
+            stats.current.selfPairs++;
+        return true;  //only counting, never filter
+    }
+
+  private:
+    CollisionStats& stats;
+};
+
+class CollisionStats::NarrowphaseCounter : public ChCollisionSystem::NarrowphaseCallback {
+  public:
+    explicit NarrowphaseCounter(CollisionStats& stats) : stats(stats) {}
+
+    virtual bool OnNarrowphase(ChCollisionInfo& contactinfo) override {
+        stats.current.narrowphasePoints++;
+        return true;
+    }
+
+  private:
+    CollisionStats& stats;
+};
+
+CollisionStats::CollisionStats(ChSystem& system) : system(system) {
+    collisionSystem = system.GetCollisionSystem();
+    if (!collisionSystem)
+        return;
+    broadphase.reset(new BroadphaseCounter(*this));
+    narrowphase.reset(new NarrowphaseCounter(*this));
+    collisionSystem->RegisterBroadphaseCallback(broadphase.get());
+    collisionSystem->RegisterNarrowphaseCallback(narrowphase.get());
+}
+
+CollisionStats::~CollisionStats() {
+    if (!collisionSystem)
+        return;
+    collisionSystem->RegisterBroadphaseCallback(nullptr);
+    collisionSystem->RegisterNarrowphaseCallback(nullptr);
+}
+
+void CollisionStats::WatchRover(const RoverModel& rover) {
+    roverBodies.insert(rover.chassis.get());
+    for (const auto& wheel : rover.wheels)
+        roverBodies.insert(wheel.get());
+    for (const auto& leg : rover.legs)
+        roverBodies.insert(leg.get());
+}
+
+void CollisionStats::Record() {
+    if (!collisionSystem)
+        return;
+    current.contacts = system.GetNcontacts();
+    pairs += current.broadphasePairs;
+    points += current.narrowphasePoints;
+    contacts += current.contacts;
+    selfPairs += current.selfPairs;
+    max.broadphasePairs = std::max(max.broadphasePairs, current.broadphasePairs);
+    max.narrowphasePoints = std::max(max.narrowphasePoints, current.narrowphasePoints);
+    max.contacts = std::max(max.contacts, current.contacts);
+    max.selfPairs = std::max(max.selfPairs, current.selfPairs);
+    numSteps++;
+    last = current;
+    current = CollisionStepCounts();
+}
+
+void CollisionStats::PrintSummary(std::ostream& out) const {
+    if (!collisionSystem) {
+        out << "COLLISION STATS: no collision system, nothing recorded" << std::endl;
+        return;
+    }
+    double n = numSteps == 0 ? 1 : (double)numSteps;
+    out << "COLLISION STATS: " << numSteps << " steps (mean / max per step)" << std::endl;
+    out << "BROADPHASE PAIRS: " << pairs / n << " / " << max.broadphasePairs << std::endl;
+    out << "NARROWPHASE POINTS: " << points / n << " / " << max.narrowphasePoints << std::endl;
+    out << "CONTACTS: " << contacts / n << " / " << max.contacts << std::endl;
+    if (!roverBodies.empty())
+        out << "ROVER SELF PAIRS: " << selfPairs / n << " / " << max.selfPairs << std::endl;
+}
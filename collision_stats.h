@@ -0,0 +1,74 @@
+// =============================================================================
+// Per-step collision detection counters.
+//
+// Counts, for every step, the shape pairs the broadphase handed on to the
+// narrowphase, the contact points the narrowphase produced and the contacts
+// that reached the solver. Pairs filtered by collision families (see
+// RoverCollisionFamily) never reach the broadphase callback, so comparing a
+// run with and without filterSelfCollision shows how many pairs the families
+// save. Pairs between two bodies of a watched rover are counted separately.
+//
+// Uses the broadphase and narrowphase callbacks of the system's collision
+// system; only one CollisionStats per system. Mean and max of every counter
+// are kept as running totals, nothing per step.
+// =============================================================================
+
+#ifndef COLLISION_STATS_H
+#define COLLISION_STATS_H
+
+#include "chrono/physics/ChSystem.h"
+
+#include "rover_model.h"
+
+#include <memory>
+#include <ostream>
+#include <unordered_set>
+
+struct CollisionStepCounts {
+    int broadphasePairs = 0;  //pairs passed to the narrowphase
+    int narrowphasePoints = 0; //contact points found by the narrowphase
+    int contacts = 0;         //contacts handed to the solver
+    int selfPairs = 0;        //broadphase pairs between two bodies of a watched rover
+};
+
+class CollisionStats {
+  public:
+    explicit CollisionStats(chrono::ChSystem& system);
+    ~CollisionStats();
+
+    CollisionStats(const CollisionStats&) = delete;
+    CollisionStats& operator=(const CollisionStats&) = delete;
+
+    //false if the system has no collision system to hook into (nothing is recorded)
+    bool IsRecording() const { return collisionSystem != nullptr; }
+
+    //count pairs between two bodies of this rover as self pairs
+    void WatchRover(const RoverModel& rover);
+
+    //call after every DoStepDynamics -> adds the counts of that step
+    void Record();
+
+    size_t NumSteps() const { return numSteps; }
+    CollisionStepCounts Last() const { return last; }
+
+    //mean/max of every counter
+    void PrintSummary(std::ostream& out) const;
+
+  private:
+    class BroadphaseCounter;
+    class NarrowphaseCounter;
+
+    chrono::ChSystem& system;
+    std::shared_ptr<chrono::collision::ChCollisionSystem> collisionSystem;
+    std::unique_ptr<BroadphaseCounter> broadphase;
+    std::unique_ptr<NarrowphaseCounter> narrowphase;
+
+    std::unordered_set<const chrono::ChContactable*> roverBodies;
+    CollisionStepCounts current;
+    CollisionStepCounts last;
+    CollisionStepCounts max;
+    double pairs = 0, points = 0, contacts = 0, selfPairs = 0;  //totals over all steps
+    size_t numSteps = 0;
+};
+
+#endif
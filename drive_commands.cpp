@@ -0,0 +1,238 @@
+#include "drive_commands.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+DriveCommandStream::DriveCommandStream(const DriveCommandSettings& settings) : settings(settings) {}
+
+DriveCommandStream::~DriveCommandStream() {
+    stopReader = true;
+    if (reader.joinable())
+        reader.join();
+}
+
+bool DriveCommandStream::Open(const std::string& path) {
+    this->path = path;
+    csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+    file.open(path, csv ? std::ios::in : std::ios::in | std::ios::binary);
+    if (!file) {
+        std::cerr << "Could not open drive log " << path << std::endl;
+        return false;
+    }
+    if (!ReadHeader())
+        return false;
+
+    chunks.resize(std::min(std::max(settings.numChunks, 2), 8));
+    for (size_t i = 0; i < chunks.size(); i++) {
+        chunks[i].times.resize(std::max<size_t>(settings.chunkSamples, 1));
+        chunks[i].values.resize(chunks[i].times.size() * numChannels);
+        freeChunks.Push((int)i);
+    }
+    binaryValues.resize(numChannels);
+    previous.assign(numChannels, 0.0);
+    output.assign(numChannels, 0.0);
+
+    reader = std::thread(&DriveCommandStream::ReaderLoop, this);
+    NextChunk();
+    stalls = 0;
+    stallTime = 0;
+    return true;
+}
+
+bool DriveCommandStream::ReadHeader() {
+    if (!csv) {
+        DriveLogHeader header;
+        file.read((char*)&header, sizeof(header));
+        if (!file || memcmp(header.magic, "ROVDRIVE", 8) != 0 || header.version != 1) {
+            std::cerr << path << " is not a version 1 binary drive log" << std::endl;
+            return false;
+        }
+        if (header.numChannels == 0 || header.numChannels > 64 || header.quantity > DRIVE_SPEED) {
+            std::cerr << path << ": bad channel count or quantity in header" << std::endl;
+            return false;
+        }
+        numChannels = header.numChannels;
+        quantity = (DriveQuantity)header.quantity;
+        return true;
+    }
+
+    while (std::getline(file, line))
+        if (!line.empty() && line[0] != '#')
+            break;
+    std::vector<std::string> names;
+    size_t start = 0;
+    while (start <= line.size()) {
+        size_t end = line.find(',', start);
+        if (end == std::string::npos)
+            end = line.size();
+        std::string name = line.substr(start, end - start);
+        while (!name.empty() && (name.back() == '\r' || name.back() == ' '))
+            name.pop_back();
+        names.push_back(name);
+        start = end + 1;
+    }
+    if (names.size() < 2) {
+        std::cerr << path << ": expected a header row time,<channel>,..." << std::endl;
+        return false;
+    }
+    numChannels = names.size() - 1;
+    quantity = DRIVE_SPEED;
+    for (size_t c = 1; c < names.size(); c++)
+        if (names[c].size() < 6 || names[c].compare(names[c].size() - 6, 6, "_speed") != 0)
+            quantity = DRIVE_TORQUE;
+    return true;
+}
+
+bool DriveCommandStream::ReadCsvSample(double& time, double* values) {
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#' || line[0] == '\r')
+            continue;
+        const char* p = line.c_str();
+        char* end;
+        time = strtod(p, &end);
+        bool ok = end != p;
+        for (size_t c = 0; ok && c < numChannels; c++) {
+            p = end;
+            if (*p != ',') {
+                ok = false;
+                break;
+            }
+            values[c] = strtod(++p, &end);
+            ok = end != p;
+        }
+        if (!ok || time < lastReadTime) {
+            badLines++;
+            continue;
+        }
+        lastReadTime = time;
+        return true;
+    }
+    return false;
+}
+
+bool DriveCommandStream::ReadBinarySample(double& time, double* values) {
+    while (true) {
+        file.read((char*)&time, sizeof(time));
+        file.read((char*)binaryValues.data(), numChannels * sizeof(float));
+        if (!file)
+            return false;
+        if (time < lastReadTime) {
+            badLines++;
+            continue;
+        }
+        for (size_t c = 0; c < numChannels; c++)
+            values[c] = binaryValues[c];
+        lastReadTime = time;
+        return true;
+    }
+}
+
+void DriveCommandStream::Fill(Chunk& chunk) {
+    chunk.count = 0;
+    chunk.last = false;
+    while (chunk.count < chunk.times.size()) {
+        double* values = &chunk.values[chunk.count * numChannels];
+        double time;
+        if (!(csv ? ReadCsvSample(time, values) : ReadBinarySample(time, values))) {
+            chunk.last = true;
+            return;
+        }
+        chunk.times[chunk.count++] = time;
+        samplesRead++;
+    }
+}
+
+void DriveCommandStream::ReaderLoop() {
+    while (!stopReader.load(std::memory_order_relaxed)) {
+        int index;
+        if (!freeChunks.Pop(index)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        Fill(chunks[index]);
+        bool last = chunks[index].last;
+        filledChunks.Push(index);
+        if (last)
+            return;
+    }
+}
+
+void DriveCommandStream::NextChunk() {
+    if (current >= 0)
+        freeChunks.Push(current);
+    int index;
+    if (!filledChunks.Pop(index)) {
+        auto start = std::chrono::steady_clock::now();
+        while (!filledChunks.Pop(index))
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        stalls++;
+        stallTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    current = index;
+    cursor = 0;
+}
+
+const double* DriveCommandStream::Sample(double time) {
+    //move past every sample at or before time, remembering the last one
+    while (!ended) {
+        const Chunk& chunk = chunks[current];
+        if (cursor < chunk.count) {
+            if (chunk.times[cursor] > time)
+                break;
+            previousTime = chunk.times[cursor];
+            std::copy_n(&chunk.values[cursor * numChannels], numChannels, previous.begin());
+            havePrevious = true;
+            cursor++;
+        } else if (chunk.last)
+            ended = true;
+        else
+            NextChunk();
+    }
+
+    if (ended) {
+        output = previous;
+        return output.data();
+    }
+    const Chunk& chunk = chunks[current];
+    const double* next = &chunk.values[cursor * numChannels];
+    if (!havePrevious) {
+        std::copy_n(next, numChannels, output.begin());
+        return output.data();
+    }
+    double f = (time - previousTime) / (chunk.times[cursor] - previousTime);
+    for (size_t c = 0; c < numChannels; c++)
+        output[c] = previous[c] + f * (next[c] - previous[c]);
+    return output.data();
+}
+
+bool DriveCommandStream::Fits(const RoverModel& rover) const {
+    return numChannels == 2 || numChannels == rover.wheelJoints.size();
+}
+
+void DriveCommandStream::Apply(RoverModel& rover, double time) {
+    const double* command = Sample(time);
+    torques.resize(rover.wheelJoints.size());
+    for (size_t i = 0; i < rover.wheelJoints.size(); i++) {
+        double value = numChannels == 2 ? command[(int)i < rover.numLeftWheels ? 0 : 1] : command[i];
+        if (quantity == DRIVE_SPEED) {
+            double torque = settings.speedGain * (value - rover.wheelJoints[i]->GetRelWvel().z());
+            value = std::max(-settings.maxTorque, std::min(settings.maxTorque, torque));
+        }
+        torques[i] = value;
+        rover.wheelJoints[i]->Set_Scr_torque(value);
+    }
+    for (auto& extra : rover.extraWheelJoints)
+        extra.second->Set_Scr_torque(torques[extra.first]);
+}
+
+void DriveCommandStream::PrintSummary(std::ostream& out) const {
+    out << "DRIVE LOG: " << path << " (" << (csv ? "csv" : "binary") << ", " << numChannels << " "
+        << (quantity == DRIVE_SPEED ? "speed" : "torque") << " channels)" << std::endl;
+    out << "DRIVE SAMPLES: " << samplesRead << " read, " << badLines << " skipped, "
+        << (ended ? "log ended at t = " : "last sample used at t = ") << previousTime << std::endl;
+    out << "DRIVE READ-AHEAD: " << chunks.size() << " chunks of " << settings.chunkSamples << " samples, " << stalls
+        << " stalls waiting for the reader (" << stallTime * 1e3 << " ms)" << std::endl;
+}
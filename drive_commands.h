@@ -0,0 +1,126 @@
+// =============================================================================
+// Streaming wheel commands from recorded drive logs.
+//
+// A drive log is a time series of per-side (2 channels: left, right) or
+// per-wheel (one channel per RoverModel wheel, model order) commands, either
+// motor torques in N*m or wheel speeds in rad/s. A background thread reads
+// the file ahead in fixed-size chunks into a few preallocated buffers and
+// hands them to the step loop through lock-free rings; the step loop
+// interpolates linearly to the current sim time. Only numChunks chunks are
+// ever in memory, so hours of recorded commands replay at a constant memory
+// cost. Before the first sample the first command holds, after the last one
+// the last command holds.
+//
+// CSV: a header row "time,<channel>,..." then one row per sample, times not
+// decreasing. Channel names ending in "_speed" make it a speed log, anything
+// else a torque log. Lines starting with '#' are skipped.
+//
+// Binary (any other extension): a DriveLogHeader, then per sample a double
+// time followed by numChannels floats, native byte order.
+//
+// Speed commands are tracked by a proportional torque on each wheel joint,
+// clamped to maxTorque.
+// =============================================================================
+
+#ifndef DRIVE_COMMANDS_H
+#define DRIVE_COMMANDS_H
+
+#include "rover_model.h"
+#include "telemetry.h"
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum DriveQuantity { DRIVE_TORQUE = 0, DRIVE_SPEED = 1 };
+
+struct DriveLogHeader {
+    char magic[8];          //"ROVDRIVE"
+    uint32_t version;       //1
+    uint32_t quantity;      //DriveQuantity
+    uint32_t numChannels;
+    uint32_t reserved;
+};
+
+struct DriveCommandSettings {
+    size_t chunkSamples = 4096;  //samples read at once
+    int numChunks = 4;           //chunks in memory, at most 8
+    double speedGain = 5.0;      //N*m per rad/s of speed error
+    double maxTorque = 20.0;     //N*m
+};
+
+class DriveCommandStream {
+  public:
+    DriveCommandStream(const DriveCommandSettings& settings = DriveCommandSettings());
+    ~DriveCommandStream();
+
+    //read the header, start the reader and wait for the first chunk. Prints what is wrong.
+    bool Open(const std::string& path);
+    bool IsOpen() const { return reader.joinable(); }
+
+    DriveQuantity Quantity() const { return quantity; }
+    size_t NumChannels() const { return numChannels; }
+
+    //true if the channels map onto this rover (2 sides or one per wheel)
+    bool Fits(const RoverModel& rover) const;
+
+    //commands at sim time, interpolated. Time must not decrease between calls. Waits only if the
+    //reader has fallen behind (counted as a stall).
+    const double* Sample(double time);
+
+    //set the wheel joint torques for the step starting at time
+    void Apply(RoverModel& rover, double time);
+
+    void PrintSummary(std::ostream& out) const;
+
+  private:
+    struct Chunk {
+        std::vector<double> times;
+        std::vector<double> values;  //numChannels per sample
+        size_t count = 0;
+        bool last = false;           //no samples after this chunk
+    };
+
+    bool ReadHeader();
+    void ReaderLoop();
+    void Fill(Chunk& chunk);
+    bool ReadCsvSample(double& time, double* values);
+    bool ReadBinarySample(double& time, double* values);
+    void NextChunk();
+
+    DriveCommandSettings settings;
+    std::string path;
+    bool csv = false;
+    DriveQuantity quantity = DRIVE_TORQUE;
+    size_t numChannels = 0;
+
+    //reader thread side
+    std::ifstream file;
+    std::vector<float> binaryValues;
+    std::string line;
+    double lastReadTime = -1e300;
+    std::atomic<long> samplesRead{0};
+    std::atomic<long> badLines{0};  //unparsable or out of order, skipped
+
+    std::vector<Chunk> chunks;
+    SpscRing<int, 8> freeChunks;
+    SpscRing<int, 8> filledChunks;
+    std::atomic<bool> stopReader{false};
+    std::thread reader;
+
+    //step loop side
+    int current = -1;
+    size_t cursor = 0;     //next sample of the current chunk
+    bool havePrevious = false;
+    bool ended = false;
+    double previousTime = 0;
+    std::vector<double> previous, output, torques;
+    long stalls = 0;
+    double stallTime = 0;  //wall seconds spent waiting for the reader
+};
+
+#endif
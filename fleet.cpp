@@ -0,0 +1,63 @@
+#include "fleet.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#include <cstdio>
+#endif
+
+using namespace chrono;
+
+std::vector<RoverModel> BuildFleet(ChSystem& system,
+                                   int count,
+                                   const FleetLayout& layout,
+                                   const std::function<RoverModel(ChSystem&)>& build) {
+    std::vector<RoverModel> fleet;
+    fleet.reserve(count);
+    int columns = layout.columns > 0 ? layout.columns : 1;
+    int rows = (count + columns - 1) / columns;
+    for (int i = 0; i < count; i++) {
+        RoverModel rover = build(system);
+        int row = i / columns;
+        int column = i % columns;
+        rover.Translate(ChVector<>((rows - 1 - row) * layout.spacingX, 0, column * layout.spacingZ));
+        fleet.push_back(rover);
+    }
+    return fleet;
+}
+
+std::vector<RoverModel> BuildFleetD(ChSystem& system, const RoverDParameters& params, int count,
+                                    const FleetLayout& layout) {
+    RoverDParameters p = params;
+    p.filterSelfCollision = p.filterSelfCollision && count <= 1;
+    return BuildFleet(system, count, layout, [&p](ChSystem& s) { return BuildRoverD(s, p); });
+}
+
+std::vector<RoverModel> BuildFleetA(ChSystem& system, const RoverAParameters& params, int count,
+                                    const FleetLayout& layout) {
+    RoverAParameters p = params;
+    p.filterSelfCollision = p.filterSelfCollision && count <= 1;
+    return BuildFleet(system, count, layout, [&p](ChSystem& s) { return BuildRoverA(s, p); });
+}
+
+size_t ResidentMemory() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.WorkingSetSize;
+    return 0;
+#else
+    //second field of /proc/self/statm is the resident set in pages (Linux)
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (!statm)
+        return 0;
+    long size = 0, resident = 0;
+    int read = fscanf(statm, "%ld %ld", &size, &resident);
+    fclose(statm);
+    if (read != 2)
+        return 0;
+    return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
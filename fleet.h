@@ -0,0 +1,48 @@
+// =============================================================================
+// Fleets of rovers in one system.
+//
+// Builds count copies of a rover model into the same ChSystem on a grid of
+// columns x rows, one copy per cell, spaced spacingX apart along X (rows
+// drive one behind the other) and spacingZ apart along Z. Each copy is an
+// ordinary RoverModel, so every rover takes its own torque commands.
+//
+// Body names repeat from rover to rover (chassis, wheelL0, ...); the index
+// in the returned vector tells them apart.
+//
+// Collision families are per system, so filterSelfCollision would also keep
+// the wheels and chassis of different rovers from colliding. BuildFleetD and
+// BuildFleetA turn it off when there is more than one rover; a build function
+// passed to BuildFleet must do the same.
+// =============================================================================
+
+#ifndef FLEET_H
+#define FLEET_H
+
+#include "rover_model.h"
+
+#include <functional>
+#include <vector>
+
+struct FleetLayout {
+    int columns = 10;      //rovers side by side (along Z)
+    double spacingX = 2.5; //grid pitch, bigger than the rover so neighbors start clear of each other
+    double spacingZ = 2.0;
+};
+
+//build count rovers with build(system), each moved to its grid cell. build must not set
+//filterSelfCollision when count > 1. Rover i is in row i / columns
+//and column i % columns; row 0 is in front (largest X), column 0 at Z = 0.
+std::vector<RoverModel> BuildFleet(chrono::ChSystem& system,
+                                   int count,
+                                   const FleetLayout& layout,
+                                   const std::function<RoverModel(chrono::ChSystem&)>& build);
+
+std::vector<RoverModel> BuildFleetD(chrono::ChSystem& system, const RoverDParameters& params, int count,
+                                    const FleetLayout& layout = FleetLayout());
+std::vector<RoverModel> BuildFleetA(chrono::ChSystem& system, const RoverAParameters& params, int count,
+                                    const FleetLayout& layout = FleetLayout());
+
+//resident memory of this process in bytes, 0 where it cannot be read
+size_t ResidentMemory();
+
+#endif
@@ -0,0 +1,163 @@
+// =============================================================================
+// Offscreen frame capture for the interactive rover simulations.
+//
+// While capturing, every drawn frame is rendered into a fixed size render
+// target texture instead of the window, read back into one of the
+// FrameEncoder's preallocated buffers and then shown in the window scaled to
+// fit. Frames are drawn once every 1 / capture-hz seconds of sim time
+// (RenderControl's render interval is set to match), so a video plays back
+// at sim speed regardless of how fast the machine steps. Conversion and file
+// writes happen on the encoder's worker threads; if they fall behind, frames
+// are dropped rather than holding up the physics.
+//
+// Command line options (any order):
+//   --capture <dir>             write frame_000000.ppm, ... into dir
+//   --capture-raw <file>        or append every frame to one raw RGB24 stream
+//   --capture-hz <hz>           frames per second of sim time (default 30)
+//   --capture-size <W>x<H>      render target size (default 1280x720)
+//   --capture-workers <n>       encoder threads (default 2)
+//   --capture-buffers <n>       frames in flight before dropping (default 8)
+// =============================================================================
+
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include "chrono_irrlicht/ChIrrApp.h"
+
+#include "frame_encoder.h"
+#include "render_control.h"
+#include "streaming_stats.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+class FrameCapture {
+  public:
+    FrameCapture(chrono::irrlicht::ChIrrApp& application) : application(application) {}
+
+    //read the options listed above, leaving everything else for the caller
+    void ParseArgs(int argc, char* argv[]) {
+        for (int i = 1; i + 1 < argc; i++) {
+            if (strcmp(argv[i], "--capture") == 0)
+                settings.directory = argv[++i];
+            else if (strcmp(argv[i], "--capture-raw") == 0)
+                settings.rawVideo = argv[++i];
+            else if (strcmp(argv[i], "--capture-hz") == 0 && atof(argv[i + 1]) > 0)
+                captureInterval = 1.0 / atof(argv[++i]);
+            else if (strcmp(argv[i], "--capture-size") == 0)
+                sscanf(argv[++i], "%ux%u", &width, &height);
+            else if (strcmp(argv[i], "--capture-workers") == 0 && atoi(argv[i + 1]) > 0)
+                settings.workers = atoi(argv[++i]);
+            else if (strcmp(argv[i], "--capture-buffers") == 0 && atoi(argv[i + 1]) > 0)
+                settings.buffers = atoi(argv[++i]);
+        }
+    }
+
+    bool IsRequested() const { return !settings.directory.empty() || !settings.rawVideo.empty(); }
+    bool IsCapturing() const { return encoder != nullptr; }
+
+    //create the render target and the encoder, and draw at the capture rate.
+    //Returns false (after printing why) if capture was requested but cannot run.
+    bool Start(RenderControl& renderControl) {
+        if (!IsRequested())
+            return true;
+        irr::video::IVideoDriver* driver = application.GetVideoDriver();
+        if (!driver->queryFeature(irr::video::EVDF_RENDER_TO_TARGET)) {
+            std::cerr << "Frame capture needs render to texture support" << std::endl;
+            return false;
+        }
+        target = driver->addRenderTargetTexture(irr::core::dimension2d<irr::u32>(width, height), "frame_capture",
+                                                irr::video::ECF_A8R8G8B8);
+        if (!target || target->getColorFormat() != irr::video::ECF_A8R8G8B8) {
+            std::cerr << "Could not create a " << width << "x" << height << " A8R8G8B8 render target" << std::endl;
+            return false;
+        }
+        //the driver may round the size, go with what we got
+        irr::core::dimension2d<irr::u32> size = target->getSize();
+        encoder.reset(new FrameEncoder(size.Width, size.Height, settings));
+        if (!encoder->Open()) {
+            encoder.reset();
+            return false;
+        }
+        renderControl.renderInterval = captureInterval;
+        return true;
+    }
+
+    //between BeginScene and DrawAll: draw into the render target instead of the window
+    void BeginFrame() {
+        if (!IsCapturing())
+            return;
+        frameStart = std::chrono::steady_clock::now();
+        application.GetVideoDriver()->setRenderTarget(target, true, true, irr::video::SColor(255, 0, 0, 0));
+        camera = application.GetSceneManager()->getActiveCamera();
+        if (camera) {
+            windowAspect = camera->getAspectRatio();
+            camera->setAspectRatio((irr::f32)encoder->Width() / encoder->Height());
+        }
+    }
+
+    //between DrawAll and EndScene: copy the frame out for encoding and show it in the window
+    void EndFrame(double simTime) {
+        if (!IsCapturing())
+            return;
+        irr::video::IVideoDriver* driver = application.GetVideoDriver();
+        driver->setRenderTarget(0, true, true, irr::video::SColor(255, 0, 0, 0));
+        if (camera)
+            camera->setAspectRatio(windowAspect);
+
+        auto readStart = std::chrono::steady_clock::now();
+        FrameEncoder::Frame* frame = encoder->Acquire();
+        if (frame) {
+            const uint8_t* pixels = (const uint8_t*)target->lock(irr::video::ETLM_READ_ONLY);
+            if (pixels) {
+                size_t rowBytes = (size_t)encoder->Width() * 4;
+                irr::u32 pitch = target->getPitch();
+                for (irr::u32 row = 0; row < encoder->Height(); row++)
+                    memcpy(&frame->pixels[row * rowBytes], pixels + (size_t)row * pitch, rowBytes);
+                target->unlock();
+            }
+            encoder->Submit(frame, simTime);
+        }
+        auto readEnd = std::chrono::steady_clock::now();
+
+        irr::core::dimension2d<irr::u32> screen = driver->getScreenSize();
+        driver->draw2DImage(target, irr::core::rect<irr::s32>(0, 0, screen.Width, screen.Height),
+                            irr::core::rect<irr::s32>(0, 0, encoder->Width(), encoder->Height()));
+
+        if (frame)
+            readbackTime.Add(std::chrono::duration<double>(readEnd - readStart).count());
+        frameTime.Add(std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStart).count());
+    }
+
+    //waits for the encoder to finish, then reports what capture cost the render thread and the workers
+    void PrintSummary(std::ostream& out) {
+        if (!IsCapturing())
+            return;
+        encoder->PrintSummary(out);
+        out << "CAPTURE COST (ms, render thread): readback mean " << readbackTime.Mean() * 1e3 << " max "
+            << readbackTime.Max() * 1e3 << ", whole frame mean " << frameTime.Mean() * 1e3 << " max "
+            << frameTime.Max() * 1e3 << std::endl;
+    }
+
+  private:
+    chrono::irrlicht::ChIrrApp& application;
+    FrameEncoderSettings settings;
+    double captureInterval = 1.0 / 30.0;
+    irr::u32 width = 1280;
+    irr::u32 height = 720;
+
+    irr::video::ITexture* target = nullptr;
+    std::unique_ptr<FrameEncoder> encoder;
+    irr::scene::ICameraSceneNode* camera = nullptr;
+    irr::f32 windowAspect = 1;
+
+    std::chrono::steady_clock::time_point frameStart;
+    RunningStats readbackTime;  //buffer acquire, texture lock and copy, s
+    RunningStats frameTime;     //render to texture through the window blit, s
+};
+
+#endif
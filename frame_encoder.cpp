@@ -0,0 +1,129 @@
+#include "frame_encoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+FrameEncoder::FrameEncoder(uint32_t width, uint32_t height, const FrameEncoderSettings& settings)
+    : width(width), height(height), settings(settings), frames(std::max(1, settings.buffers)), pool(settings.workers) {
+    for (auto& frame : frames) {
+        frame.pixels.resize((size_t)width * height * 4);
+        frame.rgb.resize((size_t)width * height * 3);
+        freeFrames.push_back(&frame);
+    }
+    inFlight.resize(frames.size(), nullptr);
+}
+
+FrameEncoder::~FrameEncoder() {
+    Finish();
+}
+
+bool FrameEncoder::Open() {
+    if (!settings.rawVideo.empty()) {
+        rawStream.open(settings.rawVideo, std::ios::binary);
+        if (!rawStream) {
+            std::cerr << "Could not open " << settings.rawVideo << std::endl;
+            return false;
+        }
+        return true;
+    }
+    std::string probe = settings.directory + "/.frame_probe";
+    std::ofstream test(probe);
+    if (!test) {
+        std::cerr << "Could not write frames to " << settings.directory << std::endl;
+        return false;
+    }
+    test.close();
+    std::remove(probe.c_str());
+    return true;
+}
+
+FrameEncoder::Frame* FrameEncoder::Acquire() {
+    std::lock_guard<std::mutex> lock(freeMutex);
+    if (freeFrames.empty()) {
+        dropped++;
+        return nullptr;
+    }
+    Frame* frame = freeFrames.back();
+    freeFrames.pop_back();
+    return frame;
+}
+
+void FrameEncoder::Submit(Frame* frame, double simTime) {
+    frame->index = submitted++;
+    frame->simTime = simTime;
+    frame->ready = false;
+    pool.Submit([this, frame]() { Encode(frame); });
+}
+
+void FrameEncoder::Release(Frame* frame) {
+    std::lock_guard<std::mutex> lock(freeMutex);
+    freeFrames.push_back(frame);
+}
+
+void FrameEncoder::Encode(Frame* frame) {
+    auto start = std::chrono::steady_clock::now();
+
+    //B G R A -> R G B
+    const uint8_t* source = frame->pixels.data();
+    uint8_t* target = frame->rgb.data();
+    size_t numPixels = (size_t)width * height;
+    for (size_t i = 0; i < numPixels; i++, source += 4, target += 3) {
+        target[0] = source[2];
+        target[1] = source[1];
+        target[2] = source[0];
+    }
+
+    if (settings.rawVideo.empty()) {
+        char name[32];
+        snprintf(name, sizeof(name), "/frame_%06ld.ppm", frame->index);
+        std::ofstream file(settings.directory + name, std::ios::binary);
+        file << "P6\n" << width << " " << height << "\n255\n";
+        file.write((const char*)frame->rgb.data(), frame->rgb.size());
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(writeMutex);
+        writeFailed = writeFailed || !file;
+        encodeTime.Add(seconds);
+        Release(frame);
+        return;
+    }
+
+    //append every frame that is next in line, this one and any that finished before it
+    std::lock_guard<std::mutex> lock(writeMutex);
+    frame->ready = true;
+    inFlight[frame->index % inFlight.size()] = frame;
+    while (true) {
+        Frame*& next = inFlight[nextToWrite % inFlight.size()];
+        if (!next || !next->ready || next->index != nextToWrite)
+            break;
+        rawStream.write((const char*)next->rgb.data(), next->rgb.size());
+        writeFailed = writeFailed || !rawStream;
+        Frame* written = next;
+        next = nullptr;
+        nextToWrite++;
+        Release(written);
+    }
+    encodeTime.Add(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
+
+void FrameEncoder::Finish() {
+    pool.Wait();
+    if (rawStream.is_open())
+        rawStream.flush();
+}
+
+void FrameEncoder::PrintSummary(std::ostream& out) {
+    Finish();
+    std::lock_guard<std::mutex> lock(writeMutex);
+    out << "FRAMES ENCODED: " << submitted << " (" << width << "x" << height << "), " << dropped
+        << " dropped with all " << frames.size() << " buffers busy" << std::endl;
+    out << "ENCODE TIME (ms, worker): mean " << encodeTime.Mean() * 1e3 << " max " << encodeTime.Max() * 1e3 << " on "
+        << pool.Size() << " workers" << std::endl;
+    if (writeFailed)
+        out << "WRITE ERRORS: some frames could not be written" << std::endl;
+    if (!settings.rawVideo.empty())
+        out << "RAW VIDEO: " << settings.rawVideo << " (ffmpeg -f rawvideo -pix_fmt rgb24 -s " << width << "x" << height
+            << " -i " << settings.rawVideo << " out.mp4)" << std::endl;
+}
@@ -0,0 +1,91 @@
+// =============================================================================
+// Background encoding of captured frames.
+//
+// Frames are copied into one of a fixed set of preallocated buffers and
+// handed to a worker pool that converts them to RGB and writes them, either
+// as numbered PPM files in a directory or appended in order to one raw
+// RGB24 video stream (ffmpeg -f rawvideo -pix_fmt rgb24 -s WxH -i file).
+// Acquire never waits: when every buffer is still being encoded it returns
+// nullptr and the frame is dropped and counted, so capture never holds up
+// the physics loop. No memory is allocated per frame.
+// =============================================================================
+
+#ifndef FRAME_ENCODER_H
+#define FRAME_ENCODER_H
+
+#include "streaming_stats.h"
+#include "thread_pool.h"
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct FrameEncoderSettings {
+    std::string directory;  //numbered PPM files go here ...
+    std::string rawVideo;   //... or, if set, every frame is appended to this raw RGB24 stream
+    unsigned workers = 2;
+    int buffers = 8;        //frames in flight before new ones are dropped
+};
+
+class FrameEncoder {
+  public:
+    //one captured frame: 32 bit pixels, byte order B G R A (Irrlicht's A8R8G8B8 in memory)
+    struct Frame {
+        std::vector<uint8_t> pixels;  //height rows of 4 * width bytes
+        std::vector<uint8_t> rgb;     //converted by the worker
+        long index = 0;
+        double simTime = 0;
+        bool ready = false;  //converted and waiting for its turn in the raw stream
+    };
+
+    FrameEncoder(uint32_t width, uint32_t height, const FrameEncoderSettings& settings);
+    ~FrameEncoder();
+
+    FrameEncoder(const FrameEncoder&) = delete;
+    FrameEncoder& operator=(const FrameEncoder&) = delete;
+
+    //open the raw stream or check the directory is writable. Prints what is wrong.
+    bool Open();
+
+    //a free buffer to copy the next frame into, nullptr if all are busy (the frame is dropped)
+    Frame* Acquire();
+    //queue an acquired buffer for encoding
+    void Submit(Frame* frame, double simTime);
+
+    //wait until every submitted frame is written
+    void Finish();
+
+    uint32_t Width() const { return width; }
+    uint32_t Height() const { return height; }
+    long Submitted() const { return submitted; }
+    long Dropped() const { return dropped; }
+
+    void PrintSummary(std::ostream& out);
+
+  private:
+    void Encode(Frame* frame);
+    void Release(Frame* frame);
+
+    uint32_t width, height;
+    FrameEncoderSettings settings;
+    std::vector<Frame> frames;
+    WorkStealingPool pool;
+
+    std::mutex freeMutex;
+    std::vector<Frame*> freeFrames;
+    long submitted = 0;
+    long dropped = 0;
+
+    //raw stream -> frames are written in index order by whichever worker finishes the next one
+    std::mutex writeMutex;
+    std::ofstream rawStream;
+    std::vector<Frame*> inFlight;  //by index % buffers
+    long nextToWrite = 0;
+    RunningStats encodeTime;
+    bool writeFailed = false;
+};
+
+#endif
@@ -0,0 +1,40 @@
+// =============================================================================
+// Memory map of a whole file (POSIX mmap, CreateFileMapping on Windows).
+// =============================================================================
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+//read/write memory map of a whole file
+class MappedFile {
+  public:
+    MappedFile();
+    ~MappedFile();
+
+    //create (or overwrite) a file of the given size and map it read/write
+    bool Create(const std::string& path, size_t size);
+    //map an existing file read only
+    bool OpenRead(const std::string& path);
+    void Close();
+
+    char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+  private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    char* data;
+    size_t size;
+#ifdef _WIN32
+    void* file;
+    void* mapping;
+#else
+    int fd;
+#endif
+};
+
+#endif
@@ -0,0 +1,134 @@
+#include "monte_carlo.h"
+#include "rover_run.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+
+using namespace chrono;
+
+//uniform in [0, 1) from the top 53 bits
+static double Uniform01(std::mt19937_64& generator) {
+    return (generator() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+//Box-Muller with two uniforms per sample (the second normal of the pair is not used)
+static double StandardNormal(std::mt19937_64& generator) {
+    double u1 = 1.0 - Uniform01(generator);  //(0, 1] -> log is finite
+    double u2 = Uniform01(generator);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * CH_C_PI * u2);
+}
+
+double ParameterDistribution::Sample(std::mt19937_64& generator) const {
+    if (kind == UNIFORM)
+        return a + (b - a) * Uniform01(generator);
+
+    //truncated normal by rejection, clamped if the bounds are too far out in the tail to hit
+    double x = a;
+    for (int tries = 0; tries < 1000; tries++) {
+        x = a + b * StandardNormal(generator);
+        if (x >= min && x <= max)
+            return x;
+    }
+    return std::max(min, std::min(max, x));
+}
+
+static std::string Trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos)
+        return "";
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+bool ReadDistributions(const std::string& path, std::vector<ParameterDistribution>& distributions) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Could not open distribution file " << path << std::endl;
+        return false;
+    }
+
+    RoverDParameters check;
+    std::string line;
+    while (std::getline(in, line)) {
+        line = Trim(line);
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        //name = kind(arguments)
+        size_t eq = line.find('=');
+        size_t open = line.find('(');
+        size_t close = line.rfind(')');
+        if (eq == std::string::npos || open == std::string::npos || close == std::string::npos || open < eq ||
+            close < open) {
+            std::cerr << "Expected \"name = normal(mean, sd)\" or \"name = uniform(min, max)\": " << line << std::endl;
+            return false;
+        }
+        ParameterDistribution distribution;
+        distribution.name = Trim(line.substr(0, eq));
+        std::string kind = Trim(line.substr(eq + 1, open - eq - 1));
+
+        std::vector<double> arguments;
+        std::string text = line.substr(open + 1, close - open - 1);
+        for (size_t start = 0; start <= text.size();) {
+            size_t comma = text.find(',', start);
+            if (comma == std::string::npos)
+                comma = text.size();
+            std::string argument = Trim(text.substr(start, comma - start));
+            if (!argument.empty())
+                arguments.push_back(atof(argument.c_str()));
+            start = comma + 1;
+        }
+
+        if (kind == "normal" && (arguments.size() == 2 || arguments.size() == 4)) {
+            distribution.kind = ParameterDistribution::NORMAL;
+            if (arguments.size() == 4) {
+                distribution.min = arguments[2];
+                distribution.max = arguments[3];
+            }
+        } else if (kind == "uniform" && arguments.size() == 2) {
+            distribution.kind = ParameterDistribution::UNIFORM;
+        } else {
+            std::cerr << "Unknown distribution or wrong number of arguments: " << line << std::endl;
+            return false;
+        }
+        distribution.a = arguments[0];
+        distribution.b = arguments[1];
+
+        if (!SetRoverDParameter(check, distribution.name, 0)) {
+            std::cerr << "Unknown parameter " << distribution.name << std::endl;
+            return false;
+        }
+        distributions.push_back(distribution);
+    }
+    if (distributions.empty()) {
+        std::cerr << "Distribution file " << path << " is empty" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static uint64_t SplitMix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+uint64_t RunSeed(uint64_t studySeed, uint64_t run) {
+    return SplitMix64(SplitMix64(studySeed) ^ run);
+}
+
+RoverDParameters SampleRoverD(const std::vector<ParameterDistribution>& distributions, uint64_t seed,
+                              std::vector<double>& values) {
+    std::mt19937_64 generator(seed);
+    RoverDParameters params;
+    values.clear();
+    for (const auto& distribution : distributions) {
+        values.push_back(distribution.Sample(generator));
+        SetRoverDParameter(params, distribution.name, values.back());
+    }
+    return params;
+}
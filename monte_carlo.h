@@ -0,0 +1,56 @@
+// =============================================================================
+// Sampled roverD parameters for Monte Carlo studies.
+//
+// A distribution file has one line per uncertain parameter:
+//
+//   wheelMass = normal(3, .15)
+//   chassisMass = normal(30, 2, 25, 35)   (mean, sd, min, max -> truncated)
+//   k = uniform(8000, 12000)
+//   wheelFriction = uniform(.4, .8)
+//
+// Names are the RoverDParameters fields (see SetRoverDParameter in
+// rover_run.h); lines starting with # are ignored. Every other parameter
+// keeps its default.
+//
+// Run r of a study draws from its own generator seeded with RunSeed(study
+// seed, r), so any run can be repeated alone and the samples do not depend
+// on how many threads ran the study or in which order runs finished. The
+// generator (std::mt19937_64) and the conversions to uniform and normal
+// samples are fully specified here, so the same seed gives the same sample
+// with every compiler and standard library.
+// =============================================================================
+
+#ifndef MONTE_CARLO_H
+#define MONTE_CARLO_H
+
+#include "rover_model.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+struct ParameterDistribution {
+    enum Kind { NORMAL, UNIFORM };
+
+    std::string name;
+    Kind kind = NORMAL;
+    double a = 0;  //mean (normal) or min (uniform)
+    double b = 0;  //standard deviation (normal) or max (uniform)
+    double min = -1e300;  //normal samples outside [min, max] are drawn again
+    double max = 1e300;
+
+    double Sample(std::mt19937_64& generator) const;
+};
+
+//print what is wrong and return false for unreadable lines and unknown parameter names
+bool ReadDistributions(const std::string& path, std::vector<ParameterDistribution>& distributions);
+
+//seed of run r of a study (splitmix64 of both, so neighbouring runs get unrelated streams)
+uint64_t RunSeed(uint64_t studySeed, uint64_t run);
+
+//defaults with every distribution sampled in file order from seed; values gets the samples in the same order
+RoverDParameters SampleRoverD(const std::vector<ParameterDistribution>& distributions, uint64_t seed,
+                              std::vector<double>& values);
+
+#endif
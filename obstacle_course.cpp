@@ -0,0 +1,189 @@
+#include "obstacle_course.h"
+
+#include "chrono/assets/ChBoxShape.h"
+#include "chrono/assets/ChCylinderShape.h"
+#include "chrono/assets/ChSphereShape.h"
+#include "chrono/assets/ChTexture.h"
+#include "chrono/physics/ChMaterialSurfaceNSC.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace chrono;
+
+//one size of one kind: a collision model every obstacle of this size copies, and its shape asset
+struct ObstacleVariant {
+    std::shared_ptr<ChBody> prototype;
+    std::shared_ptr<ChAsset> shape;
+    double size;    //rock/cylinder radius, step height, ditch depth
+    double width;   //ditch width
+};
+
+static double VariantSize(const double range[2], int variant, int numVariants) {
+    return range[0] + (range[1] - range[0]) * (variant + 0.5) / numVariants;
+}
+
+//uniform in [0, 1) from one 32 bit draw
+static double Uniform01(std::mt19937& rng) {
+    return rng() * (1.0 / 4294967296.0);
+}
+
+//kind by relative weight, u in [0, 1). Kinds of weight <= 0 are never picked.
+static int PickKind(const double weights[OBSTACLE_NUM_KINDS], double u) {
+    double total = 0;
+    for (int kind = 0; kind < OBSTACLE_NUM_KINDS; kind++)
+        total += std::max(0.0, weights[kind]);
+    double target = u * total;
+    int last = 0;
+    for (int kind = 0; kind < OBSTACLE_NUM_KINDS; kind++) {
+        if (weights[kind] <= 0)
+            continue;
+        last = kind;
+        target -= weights[kind];
+        if (target < 0)
+            return kind;
+    }
+    return last;  //rounding left target at 0
+}
+
+static std::shared_ptr<ChBody> MakePrototype() {
+    auto prototype = std::make_shared<ChBody>();
+    prototype->GetCollisionModel()->ClearModel();
+    return prototype;
+}
+
+static ObstacleVariant BoxVariant(const ChVector<>& halfSize, double size, double width) {
+    ObstacleVariant variant = { MakePrototype(), nullptr, size, width };
+    variant.prototype->GetCollisionModel()->AddBox(halfSize.x(), halfSize.y(), halfSize.z());
+    variant.prototype->GetCollisionModel()->BuildModel();
+    auto shape = std::make_shared<ChBoxShape>();
+    shape->GetBoxGeometry().Size = halfSize;
+    variant.shape = shape;
+    return variant;
+}
+
+static std::vector<ObstacleVariant> MakeVariants(ObstacleKind kind, const CourseSettings& s) {
+    double laneHalfWidth = (s.zMax - s.zMin) / 2.0;
+    std::vector<ObstacleVariant> variants;
+    for (int v = 0; v < s.sizeVariants; v++) {
+        switch (kind) {
+            case OBSTACLE_ROCK: {
+                double radius = VariantSize(s.rockRadius, v, s.sizeVariants);
+                ObstacleVariant variant = { MakePrototype(), nullptr, radius, 0 };
+                variant.prototype->GetCollisionModel()->AddSphere(radius);
+                variant.prototype->GetCollisionModel()->BuildModel();
+                auto shape = std::make_shared<ChSphereShape>();
+                shape->GetSphereGeometry().rad = radius;
+                variant.shape = shape;
+                variants.push_back(variant);
+                break;
+            }
+            case OBSTACLE_STEP: {
+                double height = VariantSize(s.stepHeight, v, s.sizeVariants);
+                variants.push_back(BoxVariant(ChVector<>(s.stepLength / 2.0, height / 2.0, laneHalfWidth), height, 0));
+                break;
+            }
+            case OBSTACLE_DITCH: {
+                //one plate; every ditch uses two
+                double depth = VariantSize(s.ditchDepth, v, s.sizeVariants);
+                double width = VariantSize(s.ditchWidth, v, s.sizeVariants);
+                variants.push_back(BoxVariant(ChVector<>(s.ditchDeckLength / 2.0, depth / 2.0, laneHalfWidth), depth, width));
+                break;
+            }
+            case OBSTACLE_CYLINDER: {
+                double radius = VariantSize(s.cylinderRadius, v, s.sizeVariants);
+                ObstacleVariant variant = { MakePrototype(), nullptr, radius, 0 };
+                //collision cylinders are along Y -> turn it across the lane (Z)
+                variant.prototype->GetCollisionModel()->AddCylinder(radius, radius, laneHalfWidth, VNULL,
+                                                                    ChMatrix33<>(Q_from_AngX(CH_C_PI / 2.0)));
+                variant.prototype->GetCollisionModel()->BuildModel();
+                auto shape = std::make_shared<ChCylinderShape>();
+                shape->GetCylinderGeometry().p1 = ChVector<>(0, 0, -laneHalfWidth);
+                shape->GetCylinderGeometry().p2 = ChVector<>(0, 0, laneHalfWidth);
+                shape->GetCylinderGeometry().rad = radius;
+                variant.shape = shape;
+                variants.push_back(variant);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return variants;
+}
+
+ObstacleCourse GenerateObstacleCourse(ChSystem& system, const CourseSettings& s) {
+    ObstacleCourse course;
+    if (s.count <= 0 || s.sizeVariants <= 0)
+        return course;
+
+    std::vector<ObstacleVariant> variants[OBSTACLE_NUM_KINDS];
+    for (int kind = 0; kind < OBSTACLE_NUM_KINDS; kind++)
+        variants[kind] = MakeVariants((ObstacleKind)kind, s);
+
+    //shared by every obstacle
+    auto material = std::make_shared<ChMaterialSurfaceNSC>();
+    std::shared_ptr<ChTexture> texture;
+    if (s.visualization) {
+        texture = std::make_shared<ChTexture>();
+        texture->SetTextureFilename(GetChronoDataFile("cubetexture_wood.png"));
+    }
+
+    auto addBody = [&](const ObstacleVariant& variant, const ChVector<>& pos) {
+        auto body = std::make_shared<ChBody>();
+        body->SetPos(pos);
+        body->SetBodyFixed(true);
+        body->SetName("obstacle");
+        body->SetMaterialSurface(material);
+        body->GetCollisionModel()->ClearModel();
+        body->GetCollisionModel()->AddCopyOfAnotherModel(variant.prototype->GetCollisionModel().get());
+        body->GetCollisionModel()->BuildModel();
+        body->SetCollide(true);
+        if (s.visualization) {
+            body->AddAsset(variant.shape);
+            body->AddAsset(texture);
+        }
+        system.Add(body);
+        course.bodies.push_back(body);
+    };
+
+    std::mt19937 rng(s.seed);
+    double laneZ = (s.zMin + s.zMax) / 2.0;
+
+    course.bodies.reserve(s.count + s.count / 4);
+    for (int i = 0; i < s.count; i++) {
+        int kind = PickKind(s.weights, Uniform01(rng));
+        int v = std::min((int)(Uniform01(rng) * s.sizeVariants), s.sizeVariants - 1);
+        const ObstacleVariant& variant = variants[kind][v];
+        double x = s.xMin + (s.xMax - s.xMin) * Uniform01(rng);
+        switch (kind) {
+            case OBSTACLE_ROCK: {
+                double z = s.zMin + (s.zMax - s.zMin) * Uniform01(rng);
+                addBody(variant, ChVector<>(x, s.floorTop, z));
+                break;
+            }
+            case OBSTACLE_STEP:
+                addBody(variant, ChVector<>(x, s.floorTop + variant.size / 2.0, laneZ));
+                break;
+            case OBSTACLE_DITCH: {
+                double offset = (variant.width + s.ditchDeckLength) / 2.0;
+                addBody(variant, ChVector<>(x - offset, s.floorTop + variant.size / 2.0, laneZ));
+                addBody(variant, ChVector<>(x + offset, s.floorTop + variant.size / 2.0, laneZ));
+                break;
+            }
+            case OBSTACLE_CYLINDER:
+                addBody(variant, ChVector<>(x, s.floorTop, laneZ));
+                break;
+        }
+        course.counts[kind]++;
+    }
+    return course;
+}
+
+void RemoveObstacleCourse(ChSystem& system, ObstacleCourse& course) {
+    for (auto& body : course.bodies)
+        system.RemoveBody(body);
+    course.bodies.clear();
+    for (int kind = 0; kind < OBSTACLE_NUM_KINDS; kind++)
+        course.counts[kind] = 0;
+}
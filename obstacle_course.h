@@ -0,0 +1,69 @@
+// =============================================================================
+// Seeded procedural obstacle courses.
+//
+// Places rocks, steps, ditches and cylinders into a rectangular region of the
+// floor. Every obstacle is a fixed body. Sizes are drawn from a few size
+// variants per kind so that all obstacles of one variant share a single
+// collision shape (copied from a prototype model), and all obstacles share
+// one contact material, one texture and per-variant visualization shapes.
+// The same seed always gives the same course, with any standard library: the
+// raw mt19937 output is turned into kinds, variants and positions by hand
+// rather than by the <random> distributions, whose output is unspecified.
+//
+//   rock     -> sphere half buried in the floor
+//   step     -> box across the lane
+//   ditch    -> trench of the given depth and width in a raised deck (two
+//               plates either side), since the floor box cannot be dug into
+//   cylinder -> lying across the lane, like the roverC cylinder obstacle
+// =============================================================================
+
+#ifndef OBSTACLE_COURSE_H
+#define OBSTACLE_COURSE_H
+
+#include "chrono/physics/ChSystem.h"
+#include "chrono/physics/ChBody.h"
+
+#include <memory>
+#include <vector>
+
+enum ObstacleKind { OBSTACLE_ROCK = 0, OBSTACLE_STEP, OBSTACLE_DITCH, OBSTACLE_CYLINDER, OBSTACLE_NUM_KINDS };
+
+struct CourseSettings {
+    unsigned seed = 1;
+    int count = 100;
+
+    //region of the floor obstacles are placed in. Steps, ditches and cylinders span all of zMin..zMax.
+    double xMin = 1.0;
+    double xMax = 30.0;
+    double zMin = -.3;
+    double zMax = 1.2;
+    double floorTop = -.3;
+
+    //relative frequency of each kind
+    double weights[OBSTACLE_NUM_KINDS] = { 1.0, 0.2, 0.1, 0.2 };
+
+    int sizeVariants = 4;  //per kind -> number of distinct collision shapes
+
+    double rockRadius[2] = { .03, .12 };       //min, max
+    double stepHeight[2] = { .03, .12 };
+    double stepLength = .2;                    //along X
+    double ditchDepth[2] = { .05, .12 };
+    double ditchWidth[2] = { .1, .25 };
+    double ditchDeckLength = .4;               //plate length either side of the trench
+    double cylinderRadius[2] = { .05, .2 };
+
+    bool visualization = true;
+};
+
+struct ObstacleCourse {
+    std::vector<std::shared_ptr<chrono::ChBody>> bodies;
+    int counts[OBSTACLE_NUM_KINDS] = { 0, 0, 0, 0 };  //obstacles (not bodies) of each kind
+};
+
+//generate the course and add its bodies to the system
+ObstacleCourse GenerateObstacleCourse(chrono::ChSystem& system, const CourseSettings& settings);
+
+//remove a generated course from the system again
+void RemoveObstacleCourse(chrono::ChSystem& system, ObstacleCourse& course);
+
+#endif
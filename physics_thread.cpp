@@ -0,0 +1,62 @@
+#include "physics_thread.h"
+
+using namespace chrono;
+
+PhysicsThread::PhysicsThread(ChSystem& system, SceneMirror& mirror, RealtimePacer* pacer)
+    : system(system), mirror(mirror), pacer(pacer), snapshots(mirror.NumBodies()) {}
+
+PhysicsThread::~PhysicsThread() {
+    Stop();
+}
+
+void PhysicsThread::Start(double stepSize, std::function<void()> onStep) {
+    if (IsRunning())
+        return;
+    this->stepSize = stepSize;
+    this->onStep = onStep;
+    stopRequested = false;
+    simStart = system.GetChTime();
+    wallStart = std::chrono::steady_clock::now();
+    thread = std::thread(&PhysicsThread::Run, this);
+}
+
+void PhysicsThread::Stop() {
+    if (!IsRunning())
+        return;
+    stopRequested = true;
+    thread.join();
+    wallEnd = std::chrono::steady_clock::now();
+}
+
+void PhysicsThread::Run() {
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        auto begin = std::chrono::steady_clock::now();
+        if (pacer)
+            pacer->Step(stepSize);
+        else
+            system.DoStepDynamics(stepSize);
+        if (onStep)
+            onStep();
+        numSteps++;
+
+        SceneSnapshot& snapshot = snapshots.Back();
+        snapshot.time = system.GetChTime();
+        snapshot.step = numSteps;
+        mirror.Capture(snapshot);
+        snapshots.Publish();
+        stepTime.Add(std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+    }
+}
+
+void PhysicsThread::PrintSummary(std::ostream& out) const {
+    double wall = std::chrono::duration<double>(wallEnd - wallStart).count();
+    double sim = system.GetChTime() - simStart;
+    out << "PHYSICS THREAD: " << numSteps << " steps, " << sim << " s sim in " << wall << " s wall ("
+        << (wall > 0 ? sim / wall : 0) << "x real time)" << std::endl;
+    out << "STEP TIME (us, physics thread): mean " << stepTime.Mean() * 1e6 << " max " << stepTime.Max() * 1e6
+        << std::endl;
+    out << "SNAPSHOTS: " << snapshots.Published() << " published, " << snapshots.Taken()
+        << " picked up by the render thread" << std::endl;
+    if (pacer)
+        pacer->PrintSummary(out);
+}
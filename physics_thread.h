@@ -0,0 +1,62 @@
+// =============================================================================
+// Physics stepping on its own thread for the interactive simulations.
+//
+// The thread steps the system back to back (or paced by a RealtimePacer),
+// calls onStep after every step and publishes the body poses into a
+// SnapshotBuffer. Nothing on the render side touches the physics system
+// while the thread runs; read the results after Stop.
+// =============================================================================
+
+#ifndef PHYSICS_THREAD_H
+#define PHYSICS_THREAD_H
+
+#include "chrono/physics/ChSystem.h"
+
+#include "realtime_pacer.h"
+#include "scene_snapshot.h"
+#include "streaming_stats.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <ostream>
+#include <thread>
+
+class PhysicsThread {
+  public:
+    //pacer may be null -> run as fast as the solver goes
+    PhysicsThread(chrono::ChSystem& system, SceneMirror& mirror, RealtimePacer* pacer = nullptr);
+    ~PhysicsThread();
+
+    PhysicsThread(const PhysicsThread&) = delete;
+    PhysicsThread& operator=(const PhysicsThread&) = delete;
+
+    void Start(double stepSize, std::function<void()> onStep);
+    //finish the current step and join
+    void Stop();
+    bool IsRunning() const { return thread.joinable(); }
+
+    SnapshotBuffer& Snapshots() { return snapshots; }
+
+    void PrintSummary(std::ostream& out) const;
+
+  private:
+    void Run();
+
+    chrono::ChSystem& system;
+    SceneMirror& mirror;
+    RealtimePacer* pacer;
+    SnapshotBuffer snapshots;
+
+    double stepSize = 0;
+    std::function<void()> onStep;
+    std::thread thread;
+    std::atomic<bool> stopRequested{false};
+
+    long numSteps = 0;
+    double simStart = 0;
+    std::chrono::steady_clock::time_point wallStart, wallEnd;
+    RunningStats stepTime;  //step, onStep and snapshot, s
+};
+
+#endif
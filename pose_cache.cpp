@@ -0,0 +1,126 @@
+#include "pose_cache.h"
+#include "checkpoint.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+using namespace chrono;
+
+//bump when the builders change in a way that moves the settled pose
+static const uint64_t poseCacheVersion = 1;
+
+//64 bit FNV-1a
+class ParameterHash {
+  public:
+    ParameterHash(char model) { Add(&model, 1); Add(&poseCacheVersion, sizeof(poseCacheVersion)); }
+
+    ParameterHash& operator<<(double value) {
+        if (value == 0)
+            value = 0;  //fold -0 into 0
+        Add(&value, sizeof(value));
+        return *this;
+    }
+
+    uint64_t Value() const { return hash; }
+
+  private:
+    void Add(const void* data, size_t size) {
+        const unsigned char* bytes = (const unsigned char*)data;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+
+    uint64_t hash = 14695981039346656037ull;
+};
+
+uint64_t HashRoverDParameters(const RoverDParameters& p, double floorTop) {
+    ParameterHash hash('D');
+    hash << floorTop << p.robotWidth << p.wheelWidth << p.wheelDia << p.wheelMass << p.wheelFriction << p.chassisW
+         << p.chassisL << p.chassisH << p.chassisMass << p.tibiaLength << p.tibiaAngle << p.tibiaMass << p.conW
+         << p.thighAngle << p.thighMass << p.fibulaLength << p.fibulaAngle << p.fibulaMass << p.tibiaSpringPt
+         << p.fibulaSpringPt << p.k << p.c << p.restLength << (double)p.filterSelfCollision;
+    return hash.Value();
+}
+
+uint64_t HashRoverAParameters(const RoverAParameters& p, double floorTop) {
+    ParameterHash hash('A');
+    hash << floorTop << p.inTom << p.chassisL << p.chassisH << p.chassisW << p.chassisMass << p.linkMass
+         << p.wheelRadius << p.wheelWidth << p.wheelDensity << p.springCoefOutside << p.springCoefInside
+         << p.damping_coef << p.restLengthOutside << p.restLengthInside << (double)p.filterSelfCollision;
+    return hash.Value();
+}
+
+//step with zero torque until every free body has been calm for settings.calmTime
+static void Settle(ChSystem& system, RoverModel& rover, const SettleSettings& settings) {
+    rover.SetTorque(0, 0);
+
+    double calmSince = system.GetChTime();
+    double endTime = system.GetChTime() + settings.maxTime;
+    while (system.GetChTime() < endTime) {
+        system.DoStepDynamics(settings.step_size);
+
+        bool calm = true;
+        for (const auto& body : system.Get_bodylist()) {
+            if (body->GetBodyFixed())
+                continue;
+            if (body->GetPos_dt().Length() > settings.linearTol || body->GetWvel_par().Length() > settings.angularTol) {
+                calm = false;
+                break;
+            }
+        }
+        if (!calm)
+            calmSince = system.GetChTime();
+        else if (system.GetChTime() - calmSince >= settings.calmTime)
+            return;
+    }
+    std::cerr << "Rover did not settle within " << settings.maxTime << " s, caching its pose anyway" << std::endl;
+}
+
+static bool SeedSettled(ChSystem& system, RoverModel& rover, const char* model, uint64_t key, double torqueLeft,
+                        double torqueRight, const std::string& cacheDir, const SettleSettings& settings) {
+    char name[64];
+    snprintf(name, sizeof(name), "%s_%016llx.ckpt", model, (unsigned long long)key);
+    std::string path = cacheDir.empty() ? std::string(name) : cacheDir + "/" + name;
+
+    bool cached = false;
+    if (std::ifstream(path).good())
+        cached = LoadCheckpoint(system, path);
+    if (!cached) {
+        Settle(system, rover, settings);
+
+        //sweep threads may settle the same key at once -> write privately, then rename into place
+        std::string tempPath = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        cached = SaveCheckpoint(system, tempPath);
+        if (cached && std::rename(tempPath.c_str(), path.c_str()) != 0) {
+            //rename does not replace an existing file on Windows
+            std::remove(path.c_str());
+            if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+                std::cerr << "Could not store settled pose " << path << std::endl;
+                std::remove(tempPath.c_str());
+                cached = false;
+            }
+        }
+    }
+
+    system.SetChTime(0);
+    rover.SetTorque(torqueLeft, torqueRight);
+    return cached;
+}
+
+bool SeedSettledRoverD(ChSystem& system, RoverModel& rover, const RoverDParameters& params, double floorTop,
+                       const std::string& cacheDir, const SettleSettings& settings) {
+    return SeedSettled(system, rover, "roverD", HashRoverDParameters(params, floorTop), params.torqueLeftSide,
+                       params.torqueRightSide, cacheDir, settings);
+}
+
+bool SeedSettledRoverA(ChSystem& system, RoverModel& rover, const RoverAParameters& params, double floorTop,
+                       const std::string& cacheDir, const SettleSettings& settings) {
+    return SeedSettled(system, rover, "roverA", HashRoverAParameters(params, floorTop), params.torqueLeftSide,
+                       params.torqueRightSide, cacheDir, settings);
+}
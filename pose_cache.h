@@ -0,0 +1,44 @@
+// =============================================================================
+// On-disk cache of settled rover poses.
+//
+// Dropping a rover onto the floor and waiting for its springs to settle takes
+// the first second or so of every run. The settled state only depends on the
+// geometry, masses and spring parameters (not on torques or obstacles), so it
+// is stored as a checkpoint (checkpoint.h) named after a hash of those
+// parameters and reused by every later run with the same hash.
+//
+// The rover is settled on the floor with zero torque; obstacles must not
+// touch it in its starting position. After seeding, the system time is reset
+// to 0 and the parameter torques are applied again.
+// =============================================================================
+
+#ifndef POSE_CACHE_H
+#define POSE_CACHE_H
+
+#include "rover_model.h"
+
+#include <cstdint>
+#include <string>
+
+struct SettleSettings {
+    double step_size = 0.001;
+    double maxTime = 3.0;          //give up waiting (and cache the pose anyway) after this
+    double linearTol = 0.005;      //m/s, every free body slower than this ...
+    double angularTol = 0.05;      //rad/s
+    double calmTime = 0.1;         //... for this long counts as settled
+};
+
+//hash of everything that changes the settled pose (not torques or visualization).
+//floorTop is part of the key because the pose is stored in absolute coordinates.
+uint64_t HashRoverDParameters(const RoverDParameters& params, double floorTop);
+uint64_t HashRoverAParameters(const RoverAParameters& params, double floorTop);
+
+//restore the settled pose for this rover from cacheDir, or settle it now and store it.
+//The model must have just been built into the system. Returns false if the pose could
+//neither be loaded nor stored (the rover is then left settled but uncached).
+bool SeedSettledRoverD(chrono::ChSystem& system, RoverModel& rover, const RoverDParameters& params, double floorTop,
+                       const std::string& cacheDir, const SettleSettings& settings = SettleSettings());
+bool SeedSettledRoverA(chrono::ChSystem& system, RoverModel& rover, const RoverAParameters& params, double floorTop,
+                       const std::string& cacheDir, const SettleSettings& settings = SettleSettings());
+
+#endif
@@ -0,0 +1,473 @@
+#include "quasi_static.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+
+using namespace chrono;
+
+// -----------------------------------------------------------------------------
+// TerrainProfile
+// -----------------------------------------------------------------------------
+
+bool TerrainProfile::Load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Could not open terrain profile " << path << std::endl;
+        return false;
+    }
+    xs.clear();
+    heights.clear();
+
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+        if (!isdigit((unsigned char)line[first]) && line[first] != '-' && line[first] != '.' && line[first] != '+') {
+            if (xs.empty())
+                continue;  //header
+            std::cerr << "Bad terrain profile row: " << line << std::endl;
+            return false;
+        }
+        size_t comma = line.find(',');
+        if (comma == std::string::npos) {
+            std::cerr << "Expected \"x,height\": " << line << std::endl;
+            return false;
+        }
+        double x = atof(line.c_str());
+        if (!xs.empty() && x < xs.back()) {
+            std::cerr << "Terrain profile x must not decrease: " << line << std::endl;
+            return false;
+        }
+        AddPoint(x, atof(line.c_str() + comma + 1));
+    }
+    if (xs.empty()) {
+        std::cerr << "Terrain profile " << path << " is empty" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+TerrainProfile TerrainProfile::FloorWithBox(double floorTop, const ChVector<>& boxSize, const ChVector<>& boxPos) {
+    TerrainProfile profile;
+    double top = std::max(floorTop, boxPos.y() + boxSize.y() / 2.0);
+    double front = boxPos.x() - boxSize.x() / 2.0;
+    double back = boxPos.x() + boxSize.x() / 2.0;
+    profile.AddPoint(front, floorTop);
+    profile.AddPoint(front, top);
+    profile.AddPoint(back, top);
+    profile.AddPoint(back, floorTop);
+    return profile;
+}
+
+void TerrainProfile::AddPoint(double x, double height) {
+    xs.push_back(x);
+    heights.push_back(height);
+}
+
+double TerrainProfile::Height(double x) const {
+    if (xs.empty())
+        return 0;
+    if (x <= xs.front())
+        return heights.front();
+    if (x >= xs.back())
+        return heights.back();
+    size_t i = std::upper_bound(xs.begin(), xs.end(), x) - xs.begin();  //xs[i - 1] <= x < xs[i]
+    double x0 = xs[i - 1], x1 = xs[i];
+    return heights[i - 1] + (heights[i] - heights[i - 1]) * (x - x0) / (x1 - x0);
+}
+
+double TerrainProfile::WheelCenterHeight(double x, double radius, int samples) const {
+    double highest = Height(x) + radius;
+    for (int i = 0; i < samples; i++) {
+        double u = radius * (2.0 * i / (samples - 1) - 1.0);
+        highest = std::max(highest, Height(x + u) + sqrt(std::max(0.0, radius * radius - u * u)));
+    }
+    //a vertical face inside the wheel footprint is between samples -> check its top corners too
+    size_t first = std::lower_bound(xs.begin(), xs.end(), x - radius) - xs.begin();
+    for (size_t i = first; i < xs.size() && xs[i] <= x + radius; i++) {
+        double u = xs[i] - x;
+        highest = std::max(highest, heights[i] + sqrt(std::max(0.0, radius * radius - u * u)));
+    }
+    return highest;
+}
+
+double TerrainProfile::CirclePenetration(double x, double y, double radius, double& sumX, double& sumY) const {
+    sumX = sumY = 0;
+    if (xs.empty())
+        return 0;
+
+    //every point of the profile that is locally closest to the center is one contact: the inside of a
+    //segment, or a vertex where the segments before and after it both end closest to the center
+    double squares = 0;
+    auto contact = [&](double px, double py) {
+        double dx = x - px, dy = y - py;
+        double distance = sqrt(dx * dx + dy * dy);
+        double penetration = radius - distance;
+        if (penetration <= 0 || distance <= 0)
+            return;
+        squares += penetration * penetration;
+        sumX += penetration * dx / distance;
+        sumY += penetration * dy / distance;
+    };
+
+    //walk the profile near x one point at a time
+    bool started = false, haveSegment = false;
+    double startX = 0, startY = 0, lastT = 0;
+    auto next = [&](double px, double py) {
+        if (!started) {
+            startX = px;
+            startY = py;
+            started = true;
+            return;
+        }
+        double dx = px - startX, dy = py - startY;
+        double length2 = dx * dx + dy * dy;
+        if (length2 <= 0)
+            return;  //repeated point
+        double t = ((x - startX) * dx + (y - startY) * dy) / length2;
+        if (haveSegment && lastT >= 1 && t <= 0)
+            contact(startX, startY);
+        if (t > 0 && t < 1)
+            contact(startX + t * dx, startY + t * dy);
+        lastT = t;
+        haveSegment = true;
+        startX = px;
+        startY = py;
+    };
+
+    //beyond the ends the profile continues flat
+    size_t first = std::lower_bound(xs.begin(), xs.end(), x - radius) - xs.begin();
+    first = first > 0 ? first - 1 : 0;
+    if (first == 0)
+        next(std::min(xs.front(), x - radius) - 1, heights.front());
+    size_t i = first;
+    for (; i < xs.size(); i++) {
+        next(xs[i], heights[i]);
+        if (xs[i] > x + radius)
+            break;
+    }
+    if (i == xs.size())
+        next(std::max(xs.back(), x + radius) + 1, heights.back());
+
+    //center below the profile -> push it back up by the full depth so a large step cannot tunnel through
+    double depth = Height(x) - y;
+    if (depth > 0) {
+        squares += (depth + radius) * (depth + radius);
+        sumY += depth + radius;
+    }
+    return squares;
+}
+
+// -----------------------------------------------------------------------------
+// RoverDQuasiStatic
+// -----------------------------------------------------------------------------
+
+static ChVector<> Rotate(const ChVector<>& v, double angle) {
+    double c = cos(angle), s = sin(angle);
+    return ChVector<>(c * v.x() - s * v.y(), s * v.x() + c * v.y(), 0);
+}
+
+//point of a body rotated by angle about pivot, from its design position
+static ChVector<> Move(const ChVector<>& point0, const ChVector<>& pivot0, const ChVector<>& pivot, double angle) {
+    return pivot + Rotate(point0 - pivot0, angle);
+}
+
+struct RoverDQuasiStatic::Pose {
+    bool valid;
+    double stretch;  //how far the fibulas would have to stretch to close the loop
+    ChVector<> hip, kneeF, kneeR, middle;
+    ChVector<> wheel[3];
+    ChVector<> springStart[2], springEnd[2];
+    ChVector<> thighCenter[2], tibiaCenter[2], fibulaCenter[2];
+};
+
+RoverDQuasiStatic::RoverDQuasiStatic(const RoverDParameters& params, const QuasiStaticSettings& settings)
+    : params(params), settings(settings) {
+    const RoverDParameters& p = params;
+    //same design geometry as BuildRoverD
+    double thighLength = p.ThighLength();
+    double tibX = p.tibiaLength * cos(p.tibiaAngle);
+    double tibY = p.tibiaLength * sin(p.tibiaAngle);
+    double thiX = thighLength * cos(p.thighAngle);
+    double thiY = thighLength * sin(p.thighAngle);
+    double fibX = p.fibulaLength * cos(p.fibulaAngle);
+    double fibY = p.fibulaLength * sin(p.fibulaAngle);
+
+    wheelRadius = p.wheelDia / 2.0;
+    hip = ChVector<>(-(tibX + thiX), tibY + thiY, 0);
+    kneeF = ChVector<>(-tibX, tibY, 0);
+    kneeR = ChVector<>(-(2.0 * thiX + tibX), tibY, 0);
+    middle = ChVector<>(-(fibX + tibX), tibY - fibY, 0);
+    fibulaF = (middle - kneeF).Length();
+    fibulaR = (middle - kneeR).Length();
+    ChVector<> knees = kneeR - kneeF;
+    ChVector<> toMiddle = middle - kneeF;
+    closureSign = knees.x() * toMiddle.y() - knees.y() * toMiddle.x() >= 0 ? 1 : -1;
+
+    wheel[0] = ChVector<>(0, 0, 0);
+    wheel[1] = ChVector<>(-(tibX + fibX), 0, 0);
+    wheel[2] = ChVector<>(-(2.0 * tibX + 2.0 * fibX), 0, 0);
+
+    springStart[0] = ChVector<>(-((p.tibiaLength - p.tibiaSpringPt) * cos(p.tibiaAngle)),
+                                (p.tibiaLength - p.tibiaSpringPt) * sin(p.tibiaAngle), 0);
+    springEnd[0] = ChVector<>(-(tibX + p.fibulaSpringPt * cos(p.fibulaAngle)), tibY - p.fibulaSpringPt * sin(p.fibulaAngle), 0);
+    springStart[1] = ChVector<>(-(2.0 * fibX + (p.tibiaLength + p.tibiaSpringPt) * cos(p.tibiaAngle)),
+                                (p.tibiaLength - p.tibiaSpringPt) * sin(p.tibiaAngle), 0);
+    springEnd[1] = ChVector<>(-(tibX + (2.0 * p.fibulaLength - p.fibulaSpringPt) * cos(p.fibulaAngle)),
+                              tibY - p.fibulaSpringPt * sin(p.fibulaAngle), 0);
+
+    thighCenter[0] = ChVector<>(-(tibX + .5 * thiX), tibY + .5 * thiY, 0);
+    thighCenter[1] = ChVector<>(-(tibX + 1.5 * thiX), tibY + .5 * thiY, 0);
+    tibiaCenter[0] = ChVector<>(-.5 * tibX, .5 * tibY, 0);
+    tibiaCenter[1] = ChVector<>(-(1.5 * tibX + 2 * thiX), .5 * tibY, 0);
+    fibulaCenter[0] = ChVector<>(-(tibX + .5 * fibX), .5 * fibY, 0);
+    fibulaCenter[1] = ChVector<>(-(tibX + 1.5 * fibX), .5 * fibY, 0);
+}
+
+double RoverDQuasiStatic::SideWeight() const {
+    return settings.gravity * params.RobotMass() / 2.0;
+}
+
+void RoverDQuasiStatic::Evaluate(const double q[numUnknowns], Pose& pose) const {
+    pose.hip = ChVector<>(q[0], q[1], 0);
+
+    pose.kneeF = Move(kneeF, hip, pose.hip, q[2]);
+    pose.kneeR = Move(kneeR, hip, pose.hip, q[3]);
+
+    //middle joint -> intersection of the fibula circles around both knees, on the design side
+    ChVector<> knees = pose.kneeR - pose.kneeF;
+    double d = knees.Length();
+    double a = (fibulaF * fibulaF - fibulaR * fibulaR + d * d) / (2.0 * d);
+    double h2 = fibulaF * fibulaF - a * a;
+    pose.valid = d > 1e-9;
+    if (!pose.valid)
+        return;
+    //past the straight linkage the circles miss -> keep the joint on the knee line and let the
+    //energy pay for the stretch, so the solver sees a stiff wall instead of a hole
+    pose.stretch = h2 >= 0 ? 0 : std::max(d - (fibulaF + fibulaR), fabs(fibulaF - fibulaR) - d);
+    ChVector<> normal(-knees.y() / d, knees.x() / d, 0);
+    if (h2 >= 0)
+        pose.middle = pose.kneeF + knees * (a / d) + normal * (closureSign * sqrt(h2));
+    else
+        pose.middle = pose.kneeF + knees * (std::max(-fibulaF, std::min(fibulaF, a)) / d);
+
+    ChVector<> middle0F = middle - kneeF, middleF = pose.middle - pose.kneeF;
+    ChVector<> middle0R = middle - kneeR, middleR = pose.middle - pose.kneeR;
+    double fibF = atan2(middleF.y(), middleF.x()) - atan2(middle0F.y(), middle0F.x());
+    double fibR = atan2(middleR.y(), middleR.x()) - atan2(middle0R.y(), middle0R.x());
+
+    pose.wheel[0] = Move(wheel[0], kneeF, pose.kneeF, q[4]);
+    pose.wheel[1] = Move(wheel[1], kneeF, pose.kneeF, fibF);
+    pose.wheel[2] = Move(wheel[2], kneeR, pose.kneeR, q[5]);
+
+    pose.springStart[0] = Move(springStart[0], kneeF, pose.kneeF, q[4]);
+    pose.springEnd[0] = Move(springEnd[0], kneeF, pose.kneeF, fibF);
+    pose.springStart[1] = Move(springStart[1], kneeR, pose.kneeR, q[5]);
+    pose.springEnd[1] = Move(springEnd[1], kneeR, pose.kneeR, fibR);
+
+    pose.thighCenter[0] = Move(thighCenter[0], hip, pose.hip, q[2]);
+    pose.thighCenter[1] = Move(thighCenter[1], hip, pose.hip, q[3]);
+    pose.tibiaCenter[0] = Move(tibiaCenter[0], kneeF, pose.kneeF, q[4]);
+    pose.tibiaCenter[1] = Move(tibiaCenter[1], kneeR, pose.kneeR, q[5]);
+    pose.fibulaCenter[0] = Move(fibulaCenter[0], kneeF, pose.kneeF, fibF);
+    pose.fibulaCenter[1] = Move(fibulaCenter[1], kneeR, pose.kneeR, fibR);
+}
+
+double RoverDQuasiStatic::Energy(const TerrainProfile& profile, const double q[numUnknowns]) const {
+    Pose pose;
+    Evaluate(q, pose);
+    if (!pose.valid)
+        return 1e30;
+
+    const RoverDParameters& p = params;
+    double g = settings.gravity;
+    double energy = g * (p.chassisMass / 2.0) * pose.hip.y() + .5 * settings.contactStiffness * pose.stretch * pose.stretch;
+    for (int i = 0; i < 2; i++)
+        energy += g * (p.thighMass * pose.thighCenter[i].y() + p.tibiaMass * pose.tibiaCenter[i].y() +
+                       p.fibulaMass * pose.fibulaCenter[i].y());
+    for (int w = 0; w < 3; w++) {
+        energy += g * p.wheelMass * pose.wheel[w].y();
+        double sumX, sumY;
+        energy += .5 * settings.contactStiffness *
+                  profile.CirclePenetration(pose.wheel[w].x(), pose.wheel[w].y(), wheelRadius, sumX, sumY);
+        double slip = pose.wheel[w].x() - anchor[w];
+        energy += .5 * settings.tractionStiffness * slip * slip;
+    }
+    for (int s = 0; s < 2; s++) {
+        double stretch = (pose.springEnd[s] - pose.springStart[s]).Length() - p.restLength;
+        energy += .5 * p.k * stretch * stretch;
+    }
+    return energy;
+}
+
+void RoverDQuasiStatic::InitialGuess(const TerrainProfile& profile, double offset) {
+    //design pose moved by offset and lowered until the lowest wheel touches the profile
+    double lift = -1e30;
+    for (int w = 0; w < 3; w++) {
+        anchor[w] = wheel[w].x() + offset;
+        lift = std::max(lift, profile.WheelCenterHeight(anchor[w], wheelRadius, settings.wheelSamples) - wheel[w].y());
+    }
+    q[0] = hip.x() + offset;
+    q[1] = hip.y() + lift;
+    for (int i = 2; i < numUnknowns; i++)
+        q[i] = 0;
+}
+
+//solve a x = b for a small dense system (Gaussian elimination, partial pivoting)
+template <int n>
+static bool SolveLinear(double a[n][n], double b[n], double x[n]) {
+    for (int c = 0; c < n; c++) {
+        int pivot = c;
+        for (int r = c + 1; r < n; r++)
+            if (fabs(a[r][c]) > fabs(a[pivot][c]))
+                pivot = r;
+        if (fabs(a[pivot][c]) < 1e-300)
+            return false;
+        std::swap(a[c], a[pivot]);
+        std::swap(b[c], b[pivot]);
+        for (int r = c + 1; r < n; r++) {
+            double f = a[r][c] / a[c][c];
+            for (int k = c; k < n; k++)
+                a[r][k] -= f * a[c][k];
+            b[r] -= f * b[c];
+        }
+    }
+    for (int r = n - 1; r >= 0; r--) {
+        double sum = b[r];
+        for (int k = r + 1; k < n; k++)
+            sum -= a[r][k] * x[k];
+        x[r] = sum / a[r][r];
+    }
+    return true;
+}
+
+QuasiStaticState RoverDQuasiStatic::Solve(const TerrainProfile& profile, double offset) {
+    const int n = numUnknowns;
+    const double eps = 1e-5;  //finite difference step, m and rad
+
+    //the wheels turn together -> each one rolls as far as the rover advanced since the last solve
+    if (!warm)
+        InitialGuess(profile, offset);
+    else
+        for (int w = 0; w < 3; w++)
+            anchor[w] += offset - lastOffset;
+    warm = true;
+    lastOffset = offset;
+
+    //damped Newton on the potential energy with a finite difference gradient and Hessian
+    QuasiStaticState state;
+    state.offset = offset;
+    double lambda = 1e-3;
+    double energy = Energy(profile, q);
+    for (state.iterations = 0; state.iterations < settings.maxIterations; state.iterations++) {
+        double plus[n], minus[n], gradient[n], hessian[n][n];
+        double x[n];
+        for (int i = 0; i < n; i++) {
+            std::copy(q, q + n, x);
+            x[i] = q[i] + eps;
+            plus[i] = Energy(profile, x);
+            x[i] = q[i] - eps;
+            minus[i] = Energy(profile, x);
+            gradient[i] = (plus[i] - minus[i]) / (2 * eps);
+            hessian[i][i] = (plus[i] - 2 * energy + minus[i]) / (eps * eps);
+        }
+        for (int i = 0; i < n; i++) {
+            for (int j = i + 1; j < n; j++) {
+                std::copy(q, q + n, x);
+                x[i] += eps;
+                x[j] += eps;
+                hessian[i][j] = hessian[j][i] = (Energy(profile, x) - plus[i] - plus[j] + energy) / (eps * eps);
+            }
+        }
+
+        //every force and moment balanced to a fraction of the weight -> in equilibrium
+        double residual = 0;
+        for (int i = 0; i < n; i++)
+            residual = std::max(residual, fabs(gradient[i]));
+        if (residual < settings.forceTolerance * SideWeight()) {
+            state.converged = true;
+            break;
+        }
+
+        //Levenberg-Marquardt damping -> grow it until the step lowers the energy
+        bool improved = false;
+        double stepLength = 0;
+        while (lambda < 1e12) {
+            double a[n][n], b[n], step[n];
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n; j++)
+                    a[i][j] = hessian[i][j];
+                a[i][i] += lambda * std::max(fabs(hessian[i][i]), 1.0);
+                b[i] = -gradient[i];
+            }
+            if (SolveLinear<n>(a, b, step)) {
+                //at most half a wheel radius (or radian) per step
+                double largest = 0;
+                for (int i = 0; i < n; i++)
+                    largest = std::max(largest, fabs(step[i]));
+                double limit = std::min(wheelRadius / 2, 0.5);
+                for (int i = 0; largest > limit && i < n; i++)
+                    step[i] *= limit / largest;
+                for (int i = 0; i < n; i++)
+                    x[i] = q[i] + step[i];
+                double trial = Energy(profile, x);
+                if (trial < energy) {
+                    stepLength = 0;
+                    for (int i = 0; i < n; i++)
+                        stepLength = std::max(stepLength, fabs(step[i]));
+                    std::copy(x, x + n, q);
+                    energy = trial;
+                    lambda = std::max(lambda / 10, 1e-9);
+                    improved = true;
+                    break;
+                }
+            }
+            lambda *= 10;
+        }
+        //no step lowers the energy any more -> at the minimum
+        if (!improved || stepLength < settings.tolerance) {
+            state.converged = true;
+            break;
+        }
+    }
+
+    Pose pose;
+    Evaluate(q, pose);
+    if (!pose.valid) {
+        state.converged = false;
+        return state;
+    }
+    state.hipHeight = pose.hip.y();
+    state.clearance = pose.hip.y() - profile.Height(pose.hip.x());
+    state.hipX = pose.hip.x();
+    state.pitch = (q[2] + q[3]) / 2.0 * 180.0 / CH_C_PI;
+    for (int w = 0; w < 3; w++) {
+        double sumX, sumY;
+        profile.CirclePenetration(pose.wheel[w].x(), pose.wheel[w].y(), wheelRadius, sumX, sumY);
+        state.wheelLoad[w] = settings.contactStiffness * sqrt(sumX * sumX + sumY * sumY);
+        state.wheelVerticalLoad[w] = settings.contactStiffness * sumY;
+        state.wheelX[w] = pose.wheel[w].x();
+        state.wheelSlip[w] = pose.wheel[w].x() - anchor[w];
+    }
+    for (int s = 0; s < 2; s++) {
+        state.springLength[s] = (pose.springEnd[s] - pose.springStart[s]).Length();
+        state.springForce[s] = params.k * (params.restLength - state.springLength[s]);
+    }
+    return state;
+}
+
+std::vector<QuasiStaticState> RoverDQuasiStatic::Traverse(const TerrainProfile& profile, double from, double to, double dx) {
+    std::vector<QuasiStaticState> states;
+    if (dx <= 0 || to < from)
+        return states;
+    Reset();
+    states.reserve((size_t)((to - from) / dx) + 1);
+    for (long i = 0; from + i * dx <= to + 1e-9 * dx; i++)
+        states.push_back(Solve(profile, from + i * dx));
+    return states;
+}
@@ -0,0 +1,135 @@
+// =============================================================================
+// Reduced order quasi-static roverD suspension model for design screening.
+//
+// Uses the same RoverDParameters as BuildRoverD but no multibody system. The
+// rover is reduced to one side in the X-Y plane (left and right see the same
+// terrain profile and carry half the weight each). For every position along
+// the profile the model finds the pose of minimum potential energy: gravity
+// on every body, the tibia-fibula springs, a stiff penalty contact of each
+// wheel with the profile and a traction spring that holds each wheel at the
+// distance it has rolled. Unknowns are the hip position, the rotation of both
+// thighs about the hip and of both tibias about their knees; the fibulas
+// follow from closing the thigh-fibula loop. A wheel in contact with several
+// profile segments (floor and step edge) is pushed off each one along its
+// contact normal.
+//
+// The wheels are taken to turn together, so every wheel rolls as far as the
+// rover advances and slips only against the traction stiffness. Without that
+// the leg frame could tip about the hip for free. The chassis is hinged on
+// the hip axis with its center of mass on the axis, so the reported pitch is
+// that of the leg frame (mean rotation of the two thighs), not of the
+// chassis box. Thigh rotations that would need the fibulas to stretch are
+// held back by the contact stiffness instead of being rejected.
+// =============================================================================
+
+#ifndef QUASI_STATIC_H
+#define QUASI_STATIC_H
+
+#include "rover_model.h"
+
+#include <string>
+#include <vector>
+
+//piecewise linear ground height along X. Two points with the same x make a vertical face.
+class TerrainProfile {
+  public:
+    //"x,height" rows; lines starting with # and a non-numeric header line are skipped
+    bool Load(const std::string& path);
+
+    //flat floor at floorTop with a box obstacle centered at (x, y) of the given X/Y size
+    //(same arguments as AddObstacleBox)
+    static TerrainProfile FloorWithBox(double floorTop, const chrono::ChVector<>& boxSize, const chrono::ChVector<>& boxPos);
+
+    //points must be added with non-decreasing x
+    void AddPoint(double x, double height);
+
+    //height at x, constant beyond the first and last point
+    double Height(double x) const;
+    //lowest height of the wheel center above x so a wheel of this radius clears the profile
+    double WheelCenterHeight(double x, double radius, int samples) const;
+    //overlap of a circle at (x, y) with every profile segment it touches. Returns the sum of the squared
+    //penetrations; (sumX, sumY) is the sum of the penetrations times the unit contact normals.
+    double CirclePenetration(double x, double y, double radius, double& sumX, double& sumY) const;
+
+    double MinX() const { return xs.empty() ? 0 : xs.front(); }
+    double MaxX() const { return xs.empty() ? 0 : xs.back(); }
+
+  private:
+    std::vector<double> xs;
+    std::vector<double> heights;
+};
+
+struct QuasiStaticSettings {
+    double gravity = 9.81;
+    double contactStiffness = 1e6;  //N/m of wheel penetration; loads are stiffness * penetration
+    double tractionStiffness = 1e4; //N/m of wheel slip along X
+    int wheelSamples = 17;          //profile samples under each wheel when placing the first pose
+    int maxIterations = 100;        //damped Newton iterations per pose
+    double tolerance = 1e-9;        //stop once a Newton step moves less than this (m, rad)
+    double forceTolerance = 2e-3;   //or once no force (N) or moment (Nm) is off by more than this times the weight
+};
+
+//pose and loads of one side of the rover
+struct QuasiStaticState {
+    double offset = 0;          //distance rolled from the design pose (front wheel at x = 0)
+    double hipX = 0;            //hip (chassis center) position
+    double hipHeight = 0;
+    double clearance = 0;       //hip height above the profile below it
+    double pitch = 0;           //leg frame pitch, degrees, nose up positive
+    double wheelLoad[3] = { 0, 0, 0 };  //front, middle, rear contact force magnitude, N
+    double wheelVerticalLoad[3] = { 0, 0, 0 };
+    double wheelX[3] = { 0, 0, 0 };
+    double wheelSlip[3] = { 0, 0, 0 };  //wheel position minus the distance it rolled
+    double springLength[2] = { 0, 0 };  //front, rear
+    double springForce[2] = { 0, 0 };   //N, positive in compression
+    int iterations = 0;
+    bool converged = false;
+};
+
+class RoverDQuasiStatic {
+  public:
+    explicit RoverDQuasiStatic(const RoverDParameters& params, const QuasiStaticSettings& settings = QuasiStaticSettings());
+
+    //pose after the wheels rolled offset along X. Starts from the previous solution and rolls the
+    //wheels on from there, so solve along increasing offsets in small increments.
+    QuasiStaticState Solve(const TerrainProfile& profile, double offset);
+
+    //Solve from offset from to to in increments of dx, starting over from the initial guess
+    std::vector<QuasiStaticState> Traverse(const TerrainProfile& profile, double from, double to, double dx);
+
+    //weight carried by one side, N
+    double SideWeight() const;
+    //front to rear wheel distance along X in the design pose
+    double WheelBase() const { return wheel[0].x() - wheel[2].x(); }
+
+    //forget the previous solution
+    void Reset() { warm = false; }
+
+  private:
+    //hip x, hip y, thigh F/R rotation, tibia F/R rotation
+    static const int numUnknowns = 6;
+
+    struct Pose;
+    void Evaluate(const double q[numUnknowns], Pose& pose) const;
+    double Energy(const TerrainProfile& profile, const double q[numUnknowns]) const;
+    void InitialGuess(const TerrainProfile& profile, double offset);
+
+    RoverDParameters params;
+    QuasiStaticSettings settings;
+    double wheelRadius;
+
+    //design configuration of one side, in the builder's coordinates
+    chrono::ChVector<> hip, kneeF, kneeR, middle;
+    double fibulaF, fibulaR;      //knee to middle joint distances
+    double closureSign;           //side of the knee line the middle joint is on
+    chrono::ChVector<> wheel[3];
+    chrono::ChVector<> springStart[2], springEnd[2];  //on tibia, on fibula
+    chrono::ChVector<> thighCenter[2], tibiaCenter[2], fibulaCenter[2];
+
+    double q[numUnknowns];
+    double anchor[3];  //where each wheel would be without slip
+    double lastOffset = 0;
+    bool warm = false;
+};
+
+#endif
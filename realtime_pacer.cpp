@@ -0,0 +1,113 @@
+#include "realtime_pacer.h"
+
+#include <algorithm>
+#include <thread>
+
+using namespace chrono;
+
+void TimeHistogram::Add(double seconds) {
+    long bin = (long)(std::max(0.0, seconds) / binWidth);
+    counts[std::min(bin, (long)counts.size() - 1)]++;
+}
+
+void TimeHistogram::Print(std::ostream& out, const char* indent) const {
+    double width = binWidth * 1e6;
+    for (size_t b = 0; b < counts.size(); b++) {
+        if (counts[b] == 0)
+            continue;
+        if (b + 1 < counts.size())
+            out << indent << b * width << " - " << (b + 1) * width << " us: " << counts[b] << std::endl;
+        else
+            out << indent << ">= " << b * width << " us: " << counts[b] << std::endl;
+    }
+}
+
+RealtimePacer::RealtimePacer(ChSystem& system, const PacerSettings& settings)
+    : system(system),
+      settings(settings),
+      stepTimeP99(.99),
+      stepHistogram(settings.binWidth, settings.numBins),
+      wakeHistogram(settings.binWidth, settings.numBins) {}
+
+void RealtimePacer::Start() {
+    wallOrigin = Clock::now();
+    simOrigin = system.GetChTime();
+    batchLeft = 0;
+    started = true;
+}
+
+RealtimePacer::Clock::time_point RealtimePacer::WallAt(double simTime) const {
+    std::chrono::duration<double> offset((simTime - simOrigin) / settings.realTimeFactor);
+    return wallOrigin + std::chrono::duration_cast<Clock::duration>(offset);
+}
+
+void RealtimePacer::SleepUntil(Clock::time_point wakeTime) {
+    //the scheduler can oversleep by a good fraction of a millisecond -> sleep short, spin the rest
+    auto spin = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(settings.spinMargin));
+    if (wakeTime - Clock::now() > spin)
+        std::this_thread::sleep_until(wakeTime - spin);
+    while (Clock::now() < wakeTime) {
+    }
+}
+
+double RealtimePacer::Lag() const {
+    if (!started)
+        return 0;
+    return std::chrono::duration<double>(Clock::now() - WallAt(system.GetChTime())).count();
+}
+
+void RealtimePacer::Step(double stepSize) {
+    if (!started)
+        Start();
+    this->stepSize = stepSize;
+
+    //first step of a batch waits for its release, unless we are already late for it
+    if (batchLeft == 0) {
+        Clock::time_point release = WallAt(system.GetChTime());
+        if (Clock::now() < release) {
+            SleepUntil(release);
+            double error = std::chrono::duration<double>(Clock::now() - release).count();
+            wakeError.Add(error);
+            wakeHistogram.Add(error);
+        }
+        batchLeft = std::max(1, settings.batchSteps);
+    }
+    batchLeft--;
+
+    Clock::time_point begin = Clock::now();
+    system.DoStepDynamics(stepSize);
+    Clock::time_point end = Clock::now();
+    numSteps++;
+
+    double computeTime = std::chrono::duration<double>(end - begin).count();
+    stepTime.Add(computeTime);
+    stepTimeP99.Add(computeTime);
+    stepHistogram.Add(computeTime);
+
+    double overrun = std::chrono::duration<double>(end - WallAt(system.GetChTime())).count();
+    if (overrun > 0) {
+        misses++;
+        if (overrun > worstOverrun) {
+            worstOverrun = overrun;
+            worstOverrunTime = system.GetChTime();
+        }
+    }
+}
+
+void RealtimePacer::PrintSummary(std::ostream& out) const {
+    out << "REALTIME PACING: factor " << settings.realTimeFactor << ", step " << stepSize << " s, "
+        << settings.batchSteps << " step(s) per release" << std::endl;
+    out << "DEADLINE MISSES: " << misses << " of " << numSteps << " steps ("
+        << (numSteps > 0 ? 100.0 * misses / numSteps : 0) << "%)" << std::endl;
+    if (misses > 0)
+        out << "WORST OVERRUN: " << worstOverrun * 1e6 << " us (step ending at t = " << worstOverrunTime << ")"
+            << std::endl;
+    out << "LAG AT END: " << Lag() * 1e6 << " us" << std::endl;
+    out << "STEP TIME (us): mean " << stepTime.Mean() * 1e6 << " sd " << stepTime.StdDev() * 1e6 << " p99 "
+        << stepTimeP99.Value() * 1e6 << " max " << stepTime.Max() * 1e6 << " (budget "
+        << stepSize / settings.realTimeFactor * 1e6 << ")" << std::endl;
+    stepHistogram.Print(out, "  ");
+    out << "WAKE-UP ERROR (us): " << wakeError.Count() << " sleeps, mean " << wakeError.Mean() * 1e6 << " max "
+        << wakeError.Max() * 1e6 << std::endl;
+    wakeHistogram.Print(out, "  ");
+}
@@ -0,0 +1,97 @@
+// =============================================================================
+// Wall-clock pacing of the physics step for hardware-in-the-loop timing tests.
+//
+// Sim time is locked to wall time at a real-time factor: the step that
+// starts at sim time t is released at wall time start + (t - t0) / factor
+// and is due when the sim time it ends at is reached on the wall clock.
+// Between releases the pacer sleeps, waking spinMargin early and spinning
+// the rest so it wakes on time rather than at the scheduler's mercy.
+// Steps are released in batches of batchSteps that run back to back, so
+// one sleep covers several short steps.
+//
+// A step that finishes after its deadline is a miss. The pacer never skips
+// steps to catch up; it runs the next step right away, so a slow stretch
+// shows up as a run of misses and the lag at the end. Step compute times and
+// wake-up errors go into preallocated histograms.
+// =============================================================================
+
+#ifndef REALTIME_PACER_H
+#define REALTIME_PACER_H
+
+#include "chrono/physics/ChSystem.h"
+
+#include "streaming_stats.h"
+
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+struct PacerSettings {
+    double realTimeFactor = 1.0;  //sim seconds per wall second
+    int batchSteps = 1;           //steps released together after one sleep
+    double spinMargin = 200e-6;   //s of every sleep spent busy-waiting
+    double binWidth = 50e-6;      //histogram bin width, s
+    int numBins = 40;             //plus one overflow bin
+};
+
+//fixed bins from 0, preallocated
+class TimeHistogram {
+  public:
+    TimeHistogram(double binWidth, int numBins) : binWidth(binWidth), counts(numBins + 1, 0) {}
+
+    void Add(double seconds);
+
+    //one line per non-empty bin, in microseconds
+    void Print(std::ostream& out, const char* indent) const;
+
+  private:
+    double binWidth;
+    std::vector<long> counts;  //last one counts everything past the last bin
+};
+
+class RealtimePacer {
+  public:
+    RealtimePacer(chrono::ChSystem& system, const PacerSettings& settings = PacerSettings());
+
+    //lock the current sim time to now. Called by the first Step if not called before.
+    void Start();
+
+    //sleep until the step is due (first step of a batch only), then DoStepDynamics
+    void Step(double stepSize);
+
+    long Steps() const { return numSteps; }
+    long Misses() const { return misses; }
+    double WorstOverrun() const { return worstOverrun; }
+    //how far the sim is behind the wall clock right now, s (negative when ahead)
+    double Lag() const;
+
+    void PrintSummary(std::ostream& out) const;
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point WallAt(double simTime) const;
+    void SleepUntil(Clock::time_point wakeTime);
+
+    chrono::ChSystem& system;
+    PacerSettings settings;
+
+    bool started = false;
+    Clock::time_point wallOrigin;
+    double simOrigin = 0;
+    int batchLeft = 0;
+
+    long numSteps = 0;
+    long misses = 0;
+    double worstOverrun = 0;
+    double worstOverrunTime = 0;  //sim time at the end of the worst step
+    double stepSize = 0;
+
+    RunningStats stepTime;
+    P2Quantile stepTimeP99;
+    RunningStats wakeError;  //actual minus scheduled wake-up, s
+    TimeHistogram stepHistogram;
+    TimeHistogram wakeHistogram;
+};
+
+#endif
@@ -0,0 +1,185 @@
+// =============================================================================
+// Render pacing for the interactive rover simulations.
+//
+// Physics keeps running at its own fixed step while the Irrlicht scene is only
+// drawn once every renderInterval seconds of sim time. Fast-forward skips
+// drawing entirely until a target sim time is reached.
+//
+// Command line options (any order):
+//   --render-hz <hz>          frames drawn per second of sim time (default 60)
+//   --fast-forward <t>        do not draw until sim time t
+//   --fast-forward-span <s>   how far the F key skips ahead (default 5 s)
+//   --realtime <factor>       lock sim time to wall time at this factor (see realtime_pacer.h)
+//   --threaded                step physics on its own thread (see physics_thread.h)
+//
+// While the window is open, the F key toggles fast-forward.
+//
+// With --threaded the Irrlicht app must be built on a separate display system
+// (use IsThreaded before creating it), and the RenderControl must be set up
+// after the model is built but before AssetBindAll. Advance then starts the
+// physics thread on its first call and afterwards only picks up the latest
+// snapshot, drawing at most once every renderInterval of sim time. Call Stop
+// before reading anything the physics thread writes.
+// =============================================================================
+
+#ifndef RENDER_CONTROL_H
+#define RENDER_CONTROL_H
+
+#include "chrono/physics/ChSystem.h"
+#include "chrono_irrlicht/ChIrrApp.h"
+
+#include "physics_thread.h"
+#include "realtime_pacer.h"
+#include "scene_snapshot.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+class RenderControl : public irr::IEventReceiver {
+  public:
+    //display -> the system the Irrlicht app draws with --threaded
+    RenderControl(chrono::ChSystem* system, chrono::ChSystem* display = nullptr) : system(system), display(display) {}
+
+    static bool IsThreaded(int argc, char* argv[]) {
+        for (int i = 1; i < argc; i++)
+            if (strcmp(argv[i], "--threaded") == 0)
+                return true;
+        return false;
+    }
+
+    //read the options listed above, leaving everything else for the caller
+    void ParseArgs(int argc, char* argv[]) {
+        for (int i = 1; i + 1 < argc; i++) {
+            if (strcmp(argv[i], "--render-hz") == 0 && atof(argv[i + 1]) > 0)
+                renderInterval = 1.0 / atof(argv[++i]);
+            else if (strcmp(argv[i], "--fast-forward") == 0)
+                fastForwardUntil = atof(argv[++i]);
+            else if (strcmp(argv[i], "--fast-forward-span") == 0)
+                fastForwardSpan = atof(argv[++i]);
+            else if (strcmp(argv[i], "--realtime") == 0 && atof(argv[i + 1]) > 0) {
+                PacerSettings pacing;
+                pacing.realTimeFactor = atof(argv[++i]);
+                pacer.reset(new RealtimePacer(*system, pacing));
+            }
+        }
+        if (IsThreaded(argc, argv)) {
+            if (display)
+                mirror.reset(new SceneMirror(*system, *display));
+            else
+                std::cerr << "--threaded is not supported by this simulation, stepping on the render thread" << std::endl;
+        }
+    }
+
+    //F toggles fast-forward: either skip ahead by fastForwardSpan or resume drawing right away
+    virtual bool OnEvent(const irr::SEvent& event) {
+        if (event.EventType != irr::EET_KEY_INPUT_EVENT || event.KeyInput.PressedDown)
+            return false;
+        if (event.KeyInput.Key != irr::KEY_KEY_F)
+            return false;
+
+        double now = FrameTime();
+        if (IsFastForwarding(now)) {
+            fastForwardUntil = 0;
+            std::cout << "Fast-forward off at t = " << now << std::endl;
+        } else {
+            fastForwardUntil = now + fastForwardSpan;
+            std::cout << "Fast-forward to t = " << fastForwardUntil << std::endl;
+        }
+        return true;
+    }
+
+    bool IsFastForwarding(double simTime) const { return simTime < fastForwardUntil; }
+
+    //sim time of the scene about to be drawn
+    double FrameTime() const { return mirror ? drawnTime : system->GetChTime(); }
+
+    //sim time at which the next frame is due. While fast-forwarding we still return to the
+    //device loop every fastForwardPoll seconds so the window keeps handling events.
+    double NextFrameTime(double simTime) const {
+        if (IsFastForwarding(simTime)) {
+            double next = simTime + fastForwardPoll;
+            return next < fastForwardUntil ? next : fastForwardUntil;
+        }
+        return simTime + renderInterval;
+    }
+
+    //step physics up to the next frame time (at least one step), calling onStep() after
+    //every step. Returns true if the frame should be drawn.
+    template <typename StepCallback>
+    bool Advance(double step_size, StepCallback onStep) {
+        if (mirror)
+            return AdvanceThreaded(step_size, onStep);
+        double frameEnd = NextFrameTime(system->GetChTime());
+        do {
+            if (pacer)
+                pacer->Step(step_size);
+            else
+                system->DoStepDynamics(step_size);
+            onStep();
+        } while (system->GetChTime() < frameEnd - 0.5 * step_size);
+        return !IsFastForwarding(system->GetChTime());
+    }
+
+    bool Advance(double step_size) {
+        return Advance(step_size, [] {});
+    }
+
+    //join the physics thread, if any. Drawing is over after this.
+    void Stop() {
+        if (physicsThread)
+            physicsThread->Stop();
+    }
+
+    //deadline misses and step times, if --realtime was given, and the physics thread with --threaded
+    void PrintSummary(std::ostream& out) {
+        if (physicsThread) {
+            Stop();
+            physicsThread->PrintSummary(out);
+            out << "FRAMES DRAWN: " << framesDrawn << std::endl;
+        } else if (pacer)
+            pacer->PrintSummary(out);
+    }
+
+    double renderInterval = 1.0 / 60.0;  //sim seconds between drawn frames
+    double fastForwardUntil = 0;         //no drawing before this sim time
+    double fastForwardSpan = 5.0;        //sim seconds skipped by the F key
+    double fastForwardPoll = 0.25;       //sim seconds between event polls while fast-forwarding
+
+  private:
+    //start the physics thread if needed, then move the display proxies to the latest snapshot
+    //if it is at least renderInterval past the last drawn one
+    template <typename StepCallback>
+    bool AdvanceThreaded(double step_size, StepCallback& onStep) {
+        if (!physicsThread) {
+            drawnTime = system->GetChTime() - renderInterval;
+            physicsThread.reset(new PhysicsThread(*system, *mirror, pacer.get()));
+            physicsThread->Start(step_size, onStep);
+        }
+        const SceneSnapshot* snapshot = physicsThread->Snapshots().Latest();
+        if (!snapshot || snapshot->time < drawnTime + renderInterval - 0.5 * step_size ||
+            IsFastForwarding(snapshot->time)) {
+            if (snapshot && IsFastForwarding(snapshot->time))
+                drawnTime = snapshot->time;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return false;
+        }
+        mirror->Apply(*snapshot);
+        drawnTime = snapshot->time;
+        framesDrawn++;
+        return true;
+    }
+
+    chrono::ChSystem* system;
+    chrono::ChSystem* display;
+    std::unique_ptr<RealtimePacer> pacer;
+
+    std::unique_ptr<SceneMirror> mirror;  //only with --threaded
+    std::unique_ptr<PhysicsThread> physicsThread;
+    double drawnTime = 0;  //sim time of the last drawn snapshot
+    long framesDrawn = 0;
+};
+
+#endif
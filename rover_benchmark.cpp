@@ -0,0 +1,297 @@
+// =============================================================================
+// Simulator throughput benchmark.
+//
+// usage: rover_benchmark [results.json] [--duration s] [--repeats n] [--only name]
+//                        [--obstacles n1,n2,...]
+//
+// Builds every model headless in a fixed scenario (the same scene, step size
+// and solver iterations as its interactive target) and times each physics
+// step:
+//
+//   pendulum -> template pendulum of rover_simulation.cpp
+//   roverA   -> 6 wheel rocker rover and its box obstacle
+//   roverC   -> 4 wheel rover, box and cylinder obstacles
+//   roverD   -> 6 wheel tibia/fibula rover and its box obstacle
+//
+// --obstacles adds one roverD scenario per count with a generated obstacle
+// course (see obstacle_course.h) in front of the rover, named obstacles_<n>.
+// The course grows in length with the count at a fixed density, so the
+// contacts near the rover stay about the same and the growth of step cost
+// and of the broadphase time shows what the extra bodies alone cost.
+//
+// Reports wall time per step, steps/sec, real time factor, step latency
+// percentiles and the broadphase/narrowphase time per step, and writes them
+// as JSON so results of different builds can be compared.
+// =============================================================================
+
+#include "chrono/physics/ChSystemNSC.h"
+#include "chrono/physics/ChBodyEasy.h"
+#include "chrono/physics/ChLinkMate.h"
+
+#include "rover_model.h"
+#include "obstacle_course.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace chrono;
+
+struct Scenario {
+    std::string name;
+    double step_size;
+    int maxIters;  //SetMaxItersSolverSpeed, 0 -> Chrono default
+    std::function<void(ChSystemNSC&)> build;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    double step_size = 0;
+    int maxIters = 0;
+    int numBodies = 0;
+    long steps = 0;
+    double simTime = 0;
+    double wallTime = 0;
+
+    //per step latency in microseconds
+    double mean = 0;
+    double min = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double max = 0;
+
+    //collision detection time per step in microseconds
+    double collisionBroad = 0;
+    double collisionNarrow = 0;
+};
+
+static void BuildPendulum(ChSystemNSC& system) {
+    auto floorBody = std::make_shared<ChBodyEasyBox>(10, 2, 10, 3000, false, false);
+    floorBody->SetPos(ChVector<>(0, -2, 0));
+    floorBody->SetBodyFixed(true);
+    system.Add(floorBody);
+
+    auto pendulumBody = std::make_shared<ChBodyEasyBox>(0.5, 2, 0.5, 3000, false, false);
+    pendulumBody->SetPos(ChVector<>(0, 3, 0));
+    pendulumBody->SetPos_dt(ChVector<>(1, 0, 0));
+    system.Add(pendulumBody);
+
+    auto sphericalLink = std::make_shared<ChLinkMateGeneric>(true, true, true, false, false, false);
+    ChFrame<> link_position_abs(ChVector<>(0, 4, 0));
+    sphericalLink->Initialize(pendulumBody, floorBody, false, link_position_abs, link_position_abs);
+    system.Add(sphericalLink);
+}
+
+static void BuildScenarioA(ChSystemNSC& system) {
+    RoverAParameters params;
+    params.visualization = false;
+    double inTom = params.inTom;
+    AddFloor(system, 0, 100, 1, false);
+    BuildRoverA(system, params);
+    AddObstacleBox(system, ChVector<>(8. * inTom, 4. * inTom, 48. * inTom), ChVector<>(60. * inTom, 2. * inTom, 0), false, 100);
+}
+
+static void BuildScenarioC(ChSystemNSC& system) {
+    RoverCParameters params;
+    params.visualization = false;
+    AddFloor(system, -.5, 100, 2, false);
+    BuildRoverC(system, params);
+    AddObstacleBox(system, ChVector<>(.2, .1, 1.22), ChVector<>(2.0, -.5, 0), false);
+    AddObstacleCylinder(system, 12 * params.in2m, 3, ChVector<>(3.0, -.5, 0), false);
+}
+
+static void BuildScenarioD(ChSystemNSC& system) {
+    RoverDParameters params;
+    params.visualization = false;
+    AddFloor(system, -.3, 100, 2, false);
+    BuildRoverD(system, params);
+    AddObstacleBox(system, ChVector<>(.2, .1, 1.22), ChVector<>(2.0, -.3, 0), false);
+}
+
+//roverD scene with a course of count obstacles, obstaclesPerMeter along the lane from x = 1
+static void BuildScenarioObstacles(ChSystemNSC& system, int count) {
+    const double obstaclesPerMeter = 20;
+    CourseSettings course;
+    course.count = count;
+    course.xMax = course.xMin + std::max(5.0, count / obstaclesPerMeter);
+    course.visualization = false;
+
+    RoverDParameters params;
+    params.visualization = false;
+    AddFloor(system, course.floorTop, 2 * (course.xMax + 2), 2, false);
+    BuildRoverD(system, params);
+    GenerateObstacleCourse(system, course);
+}
+
+//nearest-rank percentile of sorted samples
+static double Percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty())
+        return 0;
+    size_t rank = (size_t)(fraction * sorted.size() + 0.999999);
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+static BenchmarkResult RunScenario(const Scenario& scenario, double duration) {
+    ChSystemNSC system;
+    if (scenario.maxIters > 0)
+        system.SetMaxItersSolverSpeed(scenario.maxIters);
+    scenario.build(system);
+
+    BenchmarkResult result;
+    result.name = scenario.name;
+    result.step_size = scenario.step_size;
+    result.maxIters = scenario.maxIters;
+    result.numBodies = (int)system.Get_bodylist().size();
+
+    //allocate the latency buffer up front so the timed loop does not allocate
+    std::vector<double> latency;
+    latency.reserve((size_t)(duration / scenario.step_size) + 1);
+
+    double broad = 0, narrow = 0;
+    auto wallStart = std::chrono::steady_clock::now();
+    while (system.GetChTime() < duration - 0.5 * scenario.step_size) {
+        auto stepStart = std::chrono::steady_clock::now();
+        system.DoStepDynamics(scenario.step_size);
+        auto stepEnd = std::chrono::steady_clock::now();
+        latency.push_back(std::chrono::duration<double, std::micro>(stepEnd - stepStart).count());
+        //Chrono's timers cover the last step only
+        broad += system.GetTimerCollisionBroad();
+        narrow += system.GetTimerCollisionNarrow();
+    }
+    result.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    result.simTime = system.GetChTime();
+    result.steps = (long)latency.size();
+
+    std::sort(latency.begin(), latency.end());
+    if (!latency.empty()) {
+        double sum = 0;
+        for (double l : latency)
+            sum += l;
+        result.mean = sum / latency.size();
+        result.min = latency.front();
+        result.max = latency.back();
+        result.collisionBroad = 1e6 * broad / latency.size();
+        result.collisionNarrow = 1e6 * narrow / latency.size();
+    }
+    result.p50 = Percentile(latency, .50);
+    result.p90 = Percentile(latency, .90);
+    result.p99 = Percentile(latency, .99);
+    return result;
+}
+
+static void WriteJson(std::ostream& out, const std::vector<BenchmarkResult>& results, double duration) {
+    out << "{\n";
+    out << "  \"duration\": " << duration << ",\n";
+    out << "  \"scenarios\": [\n";
+    for (size_t r = 0; r < results.size(); r++) {
+        const BenchmarkResult& b = results[r];
+        double stepsPerSec = b.wallTime > 0 ? b.steps / b.wallTime : 0;
+        double rtf = b.wallTime > 0 ? b.simTime / b.wallTime : 0;
+        out << "    {\n";
+        out << "      \"name\": \"" << b.name << "\",\n";
+        out << "      \"step_size\": " << b.step_size << ",\n";
+        out << "      \"max_iters\": " << b.maxIters << ",\n";
+        out << "      \"bodies\": " << b.numBodies << ",\n";
+        out << "      \"steps\": " << b.steps << ",\n";
+        out << "      \"sim_time\": " << b.simTime << ",\n";
+        out << "      \"wall_time\": " << b.wallTime << ",\n";
+        out << "      \"wall_time_per_step_us\": " << (b.steps > 0 ? 1e6 * b.wallTime / b.steps : 0) << ",\n";
+        out << "      \"steps_per_sec\": " << stepsPerSec << ",\n";
+        out << "      \"real_time_factor\": " << rtf << ",\n";
+        out << "      \"step_latency_us\": { \"mean\": " << b.mean << ", \"min\": " << b.min << ", \"p50\": " << b.p50
+            << ", \"p90\": " << b.p90 << ", \"p99\": " << b.p99 << ", \"max\": " << b.max << " },\n";
+        out << "      \"collision_per_step_us\": { \"broad\": " << b.collisionBroad << ", \"narrow\": " << b.collisionNarrow
+            << " }\n";
+        out << "    }" << (r + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+int main(int argc, char* argv[]) {
+    SetChronoDataPath(CHRONO_DATA_DIR);
+
+    std::string jsonFile = "benchmark.json";
+    double duration = 5.0;
+    int repeats = 1;
+    std::string only;
+    std::vector<int> obstacleCounts;
+    bool valid = true;
+    bool haveFile = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc)
+            duration = atof(argv[++i]);
+        else if (strcmp(argv[i], "--repeats") == 0 && i + 1 < argc)
+            repeats = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--only") == 0 && i + 1 < argc)
+            only = argv[++i];
+        else if (strcmp(argv[i], "--obstacles") == 0 && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string count;
+            while (std::getline(list, count, ',')) {
+                obstacleCounts.push_back(atoi(count.c_str()));
+                valid = valid && obstacleCounts.back() >= 0;
+            }
+        } else if (argv[i][0] != '-' && !haveFile) {
+            jsonFile = argv[i];
+            haveFile = true;
+        } else
+            valid = false;  //unknown option, missing value or a second file
+    }
+    if (!valid || duration <= 0 || repeats < 1) {
+        std::cerr << "usage: " << argv[0] << " [results.json] [--duration s] [--repeats n] [--only name]"
+                  << " [--obstacles n1,n2,...]" << std::endl;
+        return 1;
+    }
+
+    //same step size and solver iterations as the interactive targets
+    std::vector<Scenario> scenarios = {
+        { "pendulum", 0.005, 0, BuildPendulum },
+        { "roverA", 0.001, 1000, BuildScenarioA },
+        { "roverC", 0.001, 5000, BuildScenarioC },
+        { "roverD", 0.001, 5000, BuildScenarioD },
+    };
+    for (int count : obstacleCounts)
+        scenarios.push_back({ "obstacles_" + std::to_string(count), 0.001, 5000,
+                              [count](ChSystemNSC& system) { BuildScenarioObstacles(system, count); } });
+
+    std::vector<BenchmarkResult> results;
+    for (const auto& scenario : scenarios) {
+        if (!only.empty() && scenario.name != only)
+            continue;
+        //keep the fastest repeat -> least disturbed by the rest of the machine
+        BenchmarkResult best;
+        for (int r = 0; r < repeats; r++) {
+            BenchmarkResult result = RunScenario(scenario, duration);
+            if (r == 0 || result.wallTime < best.wallTime)
+                best = result;
+        }
+        std::cout << best.name << ": " << best.steps << " steps, " << (best.wallTime > 0 ? best.steps / best.wallTime : 0)
+                  << " steps/s, RTF " << (best.wallTime > 0 ? best.simTime / best.wallTime : 0) << ", p50 " << best.p50
+                  << " us, p99 " << best.p99 << " us, max " << best.max << " us, " << best.numBodies << " bodies, broadphase "
+                  << best.collisionBroad << " us/step" << std::endl;
+        results.push_back(best);
+    }
+    if (results.empty()) {
+        std::cerr << "No scenario named " << only << std::endl;
+        return 1;
+    }
+
+    std::ofstream out(jsonFile);
+    if (!out) {
+        std::cerr << "Could not open " << jsonFile << std::endl;
+        return 1;
+    }
+    WriteJson(out, results, duration);
+    std::cout << "Results written to " << jsonFile << std::endl;
+
+    return 0;
+}
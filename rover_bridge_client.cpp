@@ -0,0 +1,95 @@
+// =============================================================================
+// Example autonomy process for the shared-memory bridge.
+//
+// usage: rover_bridge_client [name] [--speed w] [--gain k] [--max-torque t]
+//                            [--attach-timeout s]
+//
+// Attaches to the region a simulator created with roverD --bridge <name>
+// (see shm_bridge.h), then answers every state it picks up with a
+// proportional torque per wheel tracking --speed rad/s, until the simulator
+// exits. Start it before or after the simulator; in lockstep the simulator
+// waits for it. Reports how many states it saw, how many it skipped
+// (free running only) and the round trip rate.
+// =============================================================================
+
+#include "shm_bridge.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(int argc, char* argv[]) {
+    std::string name = "rover_bridge";
+    double speed = 2.0;       //target wheel speed, rad/s
+    double gain = 5.0;        //N*m per rad/s
+    double maxTorque = 10.0;  //N*m
+    double attachTimeout = 30.0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+            speed = atof(argv[++i]);
+        else if (strcmp(argv[i], "--gain") == 0 && i + 1 < argc)
+            gain = atof(argv[++i]);
+        else if (strcmp(argv[i], "--max-torque") == 0 && i + 1 < argc)
+            maxTorque = atof(argv[++i]);
+        else if (strcmp(argv[i], "--attach-timeout") == 0 && i + 1 < argc)
+            attachTimeout = atof(argv[++i]);
+        else if (argv[i][0] != '-')
+            name = argv[i];
+        else {
+            std::cerr << "usage: " << argv[0] << " [name] [--speed w] [--gain k] [--max-torque t]"
+                      << " [--attach-timeout s]" << std::endl;
+            return 1;
+        }
+    }
+
+    ShmBridgeClient client;
+    if (!client.Attach(name, attachTimeout))
+        return 1;
+    std::cout << "ATTACHED: " << name << " (" << (client.Lockstep() ? "lockstep" : "free running") << ")" << std::endl;
+
+    BridgeState state;
+    BridgeCommand command = {};
+    long received = 0;
+    long skipped = 0;   //states published but never seen, newer ones came first
+    long sent = 0;
+    long ringFull = 0;
+    bool first = true;
+    uint64_t lastSequence = 0;
+    double lastTime = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    while (client.SimulatorRunning()) {
+        if (!client.Poll(state)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (!first && state.sequence > lastSequence + 1)
+            skipped += (long)(state.sequence - lastSequence - 1);
+        first = false;
+        lastSequence = state.sequence;
+        lastTime = state.time;
+        received++;
+
+        command.sequence = state.sequence;
+        for (int w = 0; w < state.numWheels && w < RoverState::maxWheels; w++)
+            command.torque[w] = std::max(-maxTorque, std::min(maxTorque, gain * (speed - state.wheelSpeed[w])));
+        while (!client.Send(command)) {
+            ringFull++;
+            if (!client.SimulatorRunning())
+                break;
+            std::this_thread::yield();
+        }
+        sent++;
+    }
+
+    double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "SIMULATOR EXITED at t = " << lastTime << " (state " << lastSequence << ")" << std::endl;
+    std::cout << "STATES: " << received << " received, " << skipped << " skipped" << std::endl;
+    std::cout << "COMMANDS: " << sent << " sent, " << ringFull << " retries with the ring full" << std::endl;
+    std::cout << "ROUND TRIPS PER SECOND: " << (wallTime > 0 ? sent / wallTime : 0) << std::endl;
+    return 0;
+}
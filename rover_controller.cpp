@@ -0,0 +1,55 @@
+#include "rover_controller.h"
+
+using namespace chrono;
+
+const int RoverState::maxWheels;
+
+void ReadRoverState(const RoverModel& rover, const ChSystem& system, RoverState& state) {
+    state.time = system.GetChTime();
+    state.numWheels = std::min((int)rover.wheelJoints.size(), RoverState::maxWheels);
+    state.numLeftWheels = std::min(rover.numLeftWheels, state.numWheels);
+    for (int i = 0; i < state.numWheels; i++)
+        state.wheelSpeed[i] = rover.wheelJoints[i]->GetRelWvel().z();
+
+    const ChBody& chassis = *rover.chassis;
+    state.position = chassis.GetPos();
+    state.rotation = chassis.GetRot();
+    state.velocity = chassis.GetPos_dt();
+    state.angularRate = chassis.GetWvel_loc();
+    state.specificForce = state.rotation.RotateBack(chassis.GetPos_dtdt() - system.Get_G_acc());
+}
+
+void ApplyRoverCommand(RoverModel& rover, const RoverCommand& command) {
+    int numWheels = std::min((int)rover.wheelJoints.size(), RoverState::maxWheels);
+    for (int i = 0; i < numWheels; i++)
+        rover.wheelJoints[i]->Set_Scr_torque(command.torque[i]);
+    for (auto& extra : rover.extraWheelJoints)
+        if (extra.first < numWheels)
+            extra.second->Set_Scr_torque(command.torque[extra.first]);
+}
+
+void SkidSteerController::Reset(const RoverState&) {
+    integral[0] = integral[1] = 0;
+}
+
+void SkidSteerController::Update(const RoverState& state, double dt, RoverCommand& command) {
+    for (int side = 0; side < 2; side++) {
+        int begin = side == 0 ? 0 : state.numLeftWheels;
+        int end = side == 0 ? state.numLeftWheels : state.numWheels;
+        if (end <= begin)
+            continue;
+        double mean = 0;
+        for (int w = begin; w < end; w++)
+            mean += state.wheelSpeed[w];
+        mean /= end - begin;
+
+        double error = (side == 0 ? speed - turn : speed + turn) - mean;
+        double torque = kp * error + ki * (integral[side] + error * dt);
+        //anti-windup: only integrate while the output is not saturated
+        if (std::abs(torque) < maxTorque)
+            integral[side] += error * dt;
+        torque = Clamp(torque, maxTorque);
+        for (int w = begin; w < end; w++)
+            command.torque[w] = torque;
+    }
+}
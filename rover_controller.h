@@ -0,0 +1,179 @@
+// =============================================================================
+// Closed-loop wheel controllers running at their own fixed rate.
+//
+// A controller is any class with
+//     void Reset(const RoverState& state);
+//     void Update(const RoverState& state, double dt, RoverCommand& command);
+// usually derived from RoverController<Derived> (CRTP), which provides an
+// empty Reset. ControlLoop<Controller> is called before every physics step.
+// Once per control period it fills a preallocated RoverState from the wheel
+// joints and the chassis, runs the controller and writes its torques to the
+// joints, which hold them until the next control tick (zero-order hold).
+// The controller type is a template parameter, so the per-step path has no
+// virtual calls and allocates nothing. Controller time and physics time are
+// timed separately; the physics cost is Chrono's own timer of the last
+// DoStepDynamics, so pacer sleeps and recorders around the step never count.
+// =============================================================================
+
+#ifndef ROVER_CONTROLLER_H
+#define ROVER_CONTROLLER_H
+
+#include "chrono/physics/ChSystem.h"
+
+#include "rover_model.h"
+#include "streaming_stats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ostream>
+
+//what a controller sees -> plain data, filled in place
+struct RoverState {
+    static const int maxWheels = 8;
+
+    double time = 0;
+    int numWheels = 0;
+    int numLeftWheels = 0;               //wheels [0, numLeftWheels) are on the left side
+    double wheelSpeed[maxWheels] = {};   //relative to the wheel joint, rad/s
+
+    chrono::ChVector<> position;         //chassis, absolute
+    chrono::ChQuaternion<> rotation;
+    chrono::ChVector<> velocity;         //chassis, absolute, m/s
+    chrono::ChVector<> angularRate;      //chassis frame, rad/s (gyro)
+    chrono::ChVector<> specificForce;    //chassis frame, acceleration minus gravity, m/s^2 (accelerometer)
+};
+
+//what a controller writes -> one motor torque per wheel, N*m
+struct RoverCommand {
+    double torque[RoverState::maxWheels] = {};
+};
+
+//fill state from the rover's wheel joints and chassis
+void ReadRoverState(const RoverModel& rover, const chrono::ChSystem& system, RoverState& state);
+//set the wheel joint torques (and the extra joints of wheels carried by two links)
+void ApplyRoverCommand(RoverModel& rover, const RoverCommand& command);
+
+//CRTP base: shared defaults, no virtual functions
+template <typename Derived>
+class RoverController {
+  public:
+    void Reset(const RoverState&) {}
+
+  protected:
+    static double Clamp(double value, double limit) { return std::max(-limit, std::min(limit, value)); }
+};
+
+template <typename Controller>
+class ControlLoop {
+  public:
+    ControlLoop(RoverModel& rover, chrono::ChSystem& system, Controller& controller, double rate)
+        : rover(rover), system(system), controller(controller), period(1.0 / rate) {}
+
+    //before every physics step: run the controller if a control period has passed
+    void BeforeStep() {
+        double now = system.GetChTime();
+        if (numTicks == 0 || now >= nextTick - 1e-9) {
+            auto start = std::chrono::steady_clock::now();
+            ReadRoverState(rover, system, state);
+            if (numTicks == 0)
+                controller.Reset(state);
+            controller.Update(state, period, command);
+            ApplyRoverCommand(rover, command);
+            controlTime.Add(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            nextTick = (numTicks == 0 ? now : nextTick) + period;
+            if (nextTick <= now)  //steps longer than the control period -> no catching up
+                nextTick = now + period;
+            numTicks++;
+        }
+    }
+
+    //after every physics step: record its compute time
+    void AfterStep() { stepTime.Add(system.GetTimerStep()); }
+
+    const RoverState& State() const { return state; }
+    const RoverCommand& Command() const { return command; }
+
+    void PrintSummary(std::ostream& out) const {
+        out << "CONTROLLER: " << numTicks << " updates at " << 1.0 / period << " Hz, " << stepTime.Count()
+            << " physics steps" << std::endl;
+        out << "CONTROLLER COST (us per update): mean " << controlTime.Mean() * 1e6 << " max "
+            << controlTime.Max() * 1e6 << std::endl;
+        out << "PHYSICS COST (us per step): mean " << stepTime.Mean() * 1e6 << " max " << stepTime.Max() * 1e6
+            << std::endl;
+        double control = controlTime.Mean() * controlTime.Count();
+        double physics = stepTime.Mean() * stepTime.Count();
+        out << "CONTROLLER SHARE: " << (control + physics > 0 ? 100 * control / (control + physics) : 0) << "%"
+            << std::endl;
+    }
+
+  private:
+    RoverModel& rover;
+    chrono::ChSystem& system;
+    Controller& controller;
+    double period;
+
+    double nextTick = 0;
+    long numTicks = 0;
+    RoverState state;
+    RoverCommand command;
+
+    RunningStats controlTime;  //state read, controller and torque write, s
+    RunningStats stepTime;     //DoStepDynamics only, s
+};
+
+//skid steering: PI control of the mean wheel speed of each side to
+//speed - turn (left) and speed + turn (right), same torque on every wheel of a side
+class SkidSteerController : public RoverController<SkidSteerController> {
+  public:
+    double speed = 2.0;      //target wheel speed, rad/s
+    double turn = 0.0;       //half the right minus left wheel speed difference, rad/s
+    double kp = 2.0;         //N*m per rad/s
+    double ki = 4.0;         //N*m per rad
+    double maxTorque = 10.0; //N*m
+
+    void Reset(const RoverState& state);
+    void Update(const RoverState& state, double dt, RoverCommand& command);
+
+  private:
+    double integral[2] = {};  //left, right
+};
+
+//traction control around another controller: a wheel spinning more than slipThreshold rad/s faster
+//than the slowest wheel of its side gets its torque scaled down, to nothing at twice the threshold
+template <typename Inner>
+class TractionControl : public RoverController<TractionControl<Inner>> {
+  public:
+    TractionControl(Inner& inner, double slipThreshold) : inner(inner), slipThreshold(slipThreshold) {}
+
+    void Reset(const RoverState& state) { inner.Reset(state); }
+
+    void Update(const RoverState& state, double dt, RoverCommand& command) {
+        inner.Update(state, dt, command);
+        if (slipThreshold <= 0)
+            return;
+        for (int side = 0; side < 2; side++) {
+            int begin = side == 0 ? 0 : state.numLeftWheels;
+            int end = side == 0 ? state.numLeftWheels : state.numWheels;
+            double slowest = 1e300;
+            for (int w = begin; w < end; w++)
+                slowest = std::min(slowest, std::abs(state.wheelSpeed[w]));
+            for (int w = begin; w < end; w++) {
+                double excess = std::abs(state.wheelSpeed[w]) - slowest - slipThreshold;
+                if (excess > 0) {
+                    command.torque[w] *= std::max(0.0, 1.0 - excess / slipThreshold);
+                    interventions++;
+                }
+            }
+        }
+    }
+
+    long Interventions() const { return interventions; }
+
+  private:
+    Inner& inner;
+    double slipThreshold;
+    long interventions = 0;
+};
+
+#endif
@@ -0,0 +1,167 @@
+// =============================================================================
+// Fleet scaling report.
+//
+// usage: rover_fleet [report.csv] [--model A|D] [--counts n1,n2,...]
+//                    [--duration s] [--columns n]
+//
+// For every count builds a fresh system with that many rovers on a grid (see
+// fleet.h) on one floor, drives them for duration sim seconds and reports
+// steps/sec, real time factor, contacts, collision and solver time per step
+// and memory. Every rover gets its own torques (slightly different per rover
+// and per side) so the fleet spreads out instead of moving in lockstep.
+//
+// Memory is the growth of the resident set from before the system was built
+// to the end of its run. Freed memory is not always handed back to the OS, so
+// counts are run in increasing order.
+// =============================================================================
+
+#include "chrono/physics/ChSystemNSC.h"
+
+#include "rover_model.h"
+#include "fleet.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace chrono;
+
+struct FleetResult {
+    int rovers = 0;
+    int bodies = 0;
+    long steps = 0;
+    double simTime = 0;
+    double wallTime = 0;
+    double meanContacts = 0;
+    double collisionTime = 0;  //per step, microseconds
+    double solverTime = 0;
+    double memory = 0;         //MB
+};
+
+static FleetResult RunFleet(char model, int count, const FleetLayout& layout, double duration) {
+    const double step_size = 0.001;
+    size_t memoryStart = ResidentMemory();
+
+    ChSystemNSC system;
+    std::vector<RoverModel> fleet;
+    //floor is centered on the origin and the grid starts there -> twice the grid extent plus room to drive
+    int rows = (count + layout.columns - 1) / layout.columns;
+    double floorSize = 2 * (std::max(rows * layout.spacingX, std::min(count, layout.columns) * layout.spacingZ) + 10);
+    double baseTorque;
+    if (model == 'A') {
+        system.SetMaxItersSolverSpeed(1000);
+        RoverAParameters params;
+        params.visualization = false;
+        AddFloor(system, 0, floorSize, 1, false);
+        fleet = BuildFleetA(system, params, count, layout);
+        baseTorque = params.torqueLeftSide;
+    } else {
+        system.SetMaxItersSolverSpeed(5000);
+        RoverDParameters params;
+        params.visualization = false;
+        AddFloor(system, -.3, floorSize, 2, false);
+        fleet = BuildFleetD(system, params, count, layout);
+        baseTorque = params.torqueLeftSide;
+    }
+    for (size_t i = 0; i < fleet.size(); i++)
+        fleet[i].SetTorque(baseTorque * (1 + .05 * (i % 7)), baseTorque * (1 + .05 * ((i + 3) % 7)));
+
+    FleetResult result;
+    result.rovers = count;
+    result.bodies = (int)system.Get_bodylist().size();
+
+    double contacts = 0, collision = 0, solver = 0;
+    auto wallStart = std::chrono::steady_clock::now();
+    while (system.GetChTime() < duration - 0.5 * step_size) {
+        system.DoStepDynamics(step_size);
+        result.steps++;
+        contacts += system.GetNcontacts();
+        collision += system.GetTimerCollision();
+        solver += system.GetTimerSolver();
+    }
+    result.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    result.simTime = system.GetChTime();
+    if (result.steps > 0) {
+        result.meanContacts = contacts / result.steps;
+        result.collisionTime = 1e6 * collision / result.steps;
+        result.solverTime = 1e6 * solver / result.steps;
+    }
+    size_t memoryEnd = ResidentMemory();
+    result.memory = memoryEnd > memoryStart ? (memoryEnd - memoryStart) / (1024.0 * 1024.0) : 0;
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    SetChronoDataPath(CHRONO_DATA_DIR);
+
+    std::string csvFile;
+    char model = 'D';
+    std::vector<int> counts = { 1, 2, 5, 10, 20, 50, 100, 200, 400 };
+    double duration = 2.0;
+    FleetLayout layout;
+    bool valid = true;
+    bool haveFile = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+            model = argv[++i][0];
+            valid = valid && (model == 'A' || model == 'D');
+        } else if (strcmp(argv[i], "--counts") == 0 && i + 1 < argc) {
+            counts.clear();
+            std::stringstream list(argv[++i]);
+            std::string count;
+            while (std::getline(list, count, ',')) {
+                counts.push_back(atoi(count.c_str()));
+                valid = valid && counts.back() > 0;
+            }
+        } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--columns") == 0 && i + 1 < argc) {
+            layout.columns = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && !haveFile) {
+            csvFile = argv[i];
+            haveFile = true;
+        } else {
+            valid = false;  //unknown option, missing value or a second file
+        }
+    }
+    if (!valid || counts.empty() || duration <= 0 || layout.columns < 1) {
+        std::cerr << "usage: " << argv[0] << " [report.csv] [--model A|D] [--counts n1,n2,...] [--duration s]"
+                  << " [--columns n]" << std::endl;
+        return 1;
+    }
+    std::sort(counts.begin(), counts.end());
+
+    std::ofstream csv;
+    if (!csvFile.empty()) {
+        csv.open(csvFile);
+        if (!csv) {
+            std::cerr << "Could not open " << csvFile << std::endl;
+            return 1;
+        }
+        csv << "rovers,bodies,steps,sim_time,wall_time,steps_per_sec,real_time_factor,mean_contacts,"
+            << "collision_us_per_step,solver_us_per_step,memory_mb,memory_per_rover_kb\n";
+    }
+
+    for (int count : counts) {
+        FleetResult r = RunFleet(model, count, layout, duration);
+        double stepsPerSec = r.wallTime > 0 ? r.steps / r.wallTime : 0;
+        double rtf = r.wallTime > 0 ? r.simTime / r.wallTime : 0;
+        std::cout << "rover" << model << " x " << r.rovers << ": " << r.bodies << " bodies, " << stepsPerSec
+                  << " steps/s, RTF " << rtf << ", " << r.meanContacts << " contacts, collision " << r.collisionTime
+                  << " us/step, solver " << r.solverTime << " us/step, " << r.memory << " MB" << std::endl;
+        if (csv)
+            csv << r.rovers << "," << r.bodies << "," << r.steps << "," << r.simTime << "," << r.wallTime << ","
+                << stepsPerSec << "," << rtf << "," << r.meanContacts << "," << r.collisionTime << "," << r.solverTime
+                << "," << r.memory << "," << 1024 * r.memory / r.rovers << "\n";
+    }
+    if (csv)
+        std::cout << "Report written to " << csvFile << std::endl;
+
+    return 0;
+}
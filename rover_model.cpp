@@ -0,0 +1,575 @@
+#include "rover_model.h"
+
+#include "chrono/assets/ChColorAsset.h"
+#include "chrono/assets/ChPointPointDrawing.h"
+#include "chrono/assets/ChTexture.h"
+
+#include <math.h>
+
+using namespace chrono;
+
+double RoverDParameters::ThighLength() const {
+    return (tibiaLength * cos(tibiaAngle)) / cos(thighAngle);
+}
+
+double RoverDParameters::RobotLength() const {
+    return 2.0 * tibiaLength * cos(tibiaAngle) + 2.0 * fibulaLength * cos(fibulaAngle);
+}
+
+double RoverDParameters::RobotMass() const {
+    return 6 * wheelMass + 4 * tibiaMass + 4 * fibulaMass + 4 * thighMass + chassisMass;
+}
+
+void RoverModel::SetTorque(double left, double right) {
+    for (size_t i = 0; i < wheelJoints.size(); i++)
+        wheelJoints[i]->Set_Scr_torque((int)i < numLeftWheels ? left : right);
+    for (auto& extra : extraWheelJoints)
+        extra.second->Set_Scr_torque(extra.first < numLeftWheels ? left : right);
+}
+
+void RoverModel::Translate(const ChVector<>& offset) {
+    chassis->SetPos(chassis->GetPos() + offset);
+    for (auto& wheel : wheels)
+        wheel->SetPos(wheel->GetPos() + offset);
+    for (auto& leg : legs)
+        leg->SetPos(leg->GetPos() + offset);
+}
+
+static std::shared_ptr<ChLinkLockRevolute> AddRevolute(ChSystem& system,
+                                                       std::shared_ptr<ChBody> body1,
+                                                       std::shared_ptr<ChBody> body2,
+                                                       const ChVector<>& pos) {
+    auto joint = std::make_shared<ChLinkLockRevolute>();
+    joint->Initialize(body1, body2, ChCoordsys<>(pos, { 1,0,0,0 }));
+    system.Add(joint);
+    return joint;
+}
+
+static std::shared_ptr<ChBody> AddLink(ChSystem& system, double length, double width, double mass,
+                                       const ChVector<>& pos, double angle, bool visualization) {
+    auto link = std::make_shared<ChBodyEasyBox>(length, width, width,	// x,y,z size
+        200,													// density
+        false,													// collide enable?
+        visualization											// visualization?
+        );
+    link->SetMass(mass);
+    link->SetPos(pos);
+    link->SetRot(Q_from_AngZ(angle));
+    system.Add(link);
+    return link;
+}
+
+//name the bodies so recorded data (trajectory files, ...) can be matched to the model
+static void NameBodies(RoverModel& rover) {
+    rover.chassis->SetName("chassis");
+    for (size_t i = 0; i < rover.wheels.size(); i++) {
+        bool left = (int)i < rover.numLeftWheels;
+        size_t n = left ? i : i - rover.numLeftWheels;
+        rover.wheels[i]->SetName(((left ? "wheelL" : "wheelR") + std::to_string(n)).c_str());
+    }
+    for (size_t i = 0; i < rover.legs.size(); i++)
+        rover.legs[i]->SetName(("leg" + std::to_string(i)).c_str());
+}
+
+//put chassis and wheels into the RoverCollisionFamily families
+static void SetCollisionFamilies(RoverModel& rover) {
+    auto chassisModel = rover.chassis->GetCollisionModel();
+    chassisModel->SetFamily(ROVER_FAMILY_CHASSIS);
+    chassisModel->SetFamilyMaskNoCollisionWithFamily(ROVER_FAMILY_LEFT_WHEELS);
+    chassisModel->SetFamilyMaskNoCollisionWithFamily(ROVER_FAMILY_RIGHT_WHEELS);
+    for (size_t i = 0; i < rover.wheels.size(); i++) {
+        int family = (int)i < rover.numLeftWheels ? ROVER_FAMILY_LEFT_WHEELS : ROVER_FAMILY_RIGHT_WHEELS;
+        auto wheelModel = rover.wheels[i]->GetCollisionModel();
+        wheelModel->SetFamily(family);
+        wheelModel->SetFamilyMaskNoCollisionWithFamily(family);
+        wheelModel->SetFamilyMaskNoCollisionWithFamily(ROVER_FAMILY_CHASSIS);
+    }
+}
+
+RoverModel BuildRoverD(ChSystem& system, const RoverDParameters& p) {
+    RoverModel rover;
+
+    //shorthand for the design geometry
+    double thighLength = p.ThighLength();
+    double tibX = p.tibiaLength * cos(p.tibiaAngle);
+    double tibY = p.tibiaLength * sin(p.tibiaAngle);
+    double thiX = thighLength * cos(p.thighAngle);
+    double thiY = thighLength * sin(p.thighAngle);
+    double fibX = p.fibulaLength * cos(p.fibulaAngle);
+    double fibY = p.fibulaLength * sin(p.fibulaAngle);
+
+    //z of the leg links and of the wheel joints on each side (left first)
+    double legZ[2] = { p.wheelWidth / 2.0 + p.conW, p.robotWidth - (p.wheelWidth / 2.0 + p.conW) };
+    double wheelZ[2] = { 0, p.robotWidth };
+    double wheelJointZ[2] = { .5 * p.wheelWidth, p.robotWidth - .5 * p.wheelWidth };
+
+    // Add chassis
+    auto chassis = std::make_shared<ChBodyEasyBox>(p.chassisL, p.chassisH, p.chassisW,	// x,y,z size
+        200,													// density
+        true,													// collide enable?
+        p.visualization											// visualization?
+        );
+    chassis->SetMass(p.chassisMass);
+    chassis->SetPos(ChVector<>(-(tibX + thiX), tibY + thiY, p.robotWidth / 2.0));
+    system.Add(chassis);
+    chassis->SetBodyFixed(false);
+    rover.chassis = chassis;
+
+    //bodies are added side by side in the same order as the original hand-built model so
+    //the solver sees the same ordering
+    std::shared_ptr<ChBody> thighF[2], thighR[2], tibiaF[2], tibiaR[2], fibulaF[2], fibulaR[2];
+
+    //thighs -> connector from knee to chassis
+    for (int s = 0; s < 2; s++) {
+        thighF[s] = AddLink(system, thighLength, p.conW, p.thighMass,
+            ChVector<>(-(tibX + .5 * thiX), tibY + .5 * thiY, legZ[s]), -p.thighAngle, p.visualization);
+        thighR[s] = AddLink(system, thighLength, p.conW, p.thighMass,
+            ChVector<>(-(tibX + 1.5 * thiX), tibY + .5 * thiY, legZ[s]), p.thighAngle, p.visualization);
+    }
+    for (int s = 0; s < 2; s++) {
+        rover.legJoints.push_back(AddRevolute(system, chassis, thighF[s], ChVector<>(-(tibX + thiX), tibY + thiY, legZ[s])));
+        rover.legJoints.push_back(AddRevolute(system, chassis, thighR[s], ChVector<>(-(tibX + thiX), tibY + thiY, legZ[s])));
+    }
+
+    //tibias -> connector to front and rear wheels
+    for (int s = 0; s < 2; s++) {
+        tibiaF[s] = AddLink(system, p.tibiaLength, p.conW, p.tibiaMass,
+            ChVector<>(-.5 * tibX, .5 * tibY, legZ[s]), -p.tibiaAngle, p.visualization);
+        tibiaR[s] = AddLink(system, p.tibiaLength, p.conW, p.tibiaMass,
+            ChVector<>(-(1.5 * tibX + 2 * thiX), .5 * tibY, legZ[s]), p.tibiaAngle, p.visualization);
+    }
+    for (int s = 0; s < 2; s++) {
+        rover.legJoints.push_back(AddRevolute(system, thighF[s], tibiaF[s], ChVector<>(-tibX, tibY, legZ[s])));
+        rover.legJoints.push_back(AddRevolute(system, thighR[s], tibiaR[s], ChVector<>(-(2.0 * thiX + tibX), tibY, legZ[s])));
+    }
+
+    //fibulas -> connector from knee to middle wheel
+    for (int s = 0; s < 2; s++) {
+        fibulaF[s] = AddLink(system, p.fibulaLength, p.conW, p.fibulaMass,
+            ChVector<>(-(tibX + .5 * fibX), .5 * fibY, legZ[s]), p.fibulaAngle, p.visualization);
+        fibulaR[s] = AddLink(system, p.fibulaLength, p.conW, p.fibulaMass,
+            ChVector<>(-(tibX + 1.5 * fibX), .5 * fibY, legZ[s]), -p.fibulaAngle, p.visualization);
+    }
+    for (int s = 0; s < 2; s++) {
+        rover.legJoints.push_back(AddRevolute(system, thighF[s], fibulaF[s], ChVector<>(-tibX, tibY, legZ[s])));
+        rover.legJoints.push_back(AddRevolute(system, thighR[s], fibulaR[s], ChVector<>(-(2.0 * thiX + tibX), tibY, legZ[s])));
+    }
+    //to each other
+    for (int s = 0; s < 2; s++)
+        rover.legJoints.push_back(AddRevolute(system, fibulaF[s], fibulaR[s], ChVector<>(-(fibX + tibX), tibY - fibY, legZ[s])));
+
+    for (int s = 0; s < 2; s++) {
+        rover.legs.push_back(thighF[s]);
+        rover.legs.push_back(thighR[s]);
+        rover.legs.push_back(tibiaF[s]);
+        rover.legs.push_back(tibiaR[s]);
+        rover.legs.push_back(fibulaF[s]);
+        rover.legs.push_back(fibulaR[s]);
+    }
+
+    // Add wheels as cylinders
+    std::shared_ptr<ChTexture> texture;
+    if (p.visualization) {
+        texture = std::make_shared<ChTexture>();
+        texture->SetTextureFilename(GetChronoDataFile("redwhite.png"));  // texture in ../data
+    }
+
+    double wheelX[3] = { 0, -(tibX + fibX), -(2.0 * tibX + 2.0 * fibX) };
+    for (int s = 0; s < 2; s++) {
+        for (int w = 0; w < 3; w++) {
+            auto wheel = std::make_shared<ChBodyEasyCylinder>(p.wheelDia / 2.0, p.wheelWidth, 300,// density
+                true,// collide
+                p.visualization// visualization
+                );
+            wheel->SetMass(p.wheelMass);
+            wheel->GetMaterialSurfaceNSC()->SetFriction((float)p.wheelFriction);
+            wheel->SetPos(ChVector<>(wheelX[w], 0, wheelZ[s]));
+            wheel->SetRot(Q_from_AngX(CH_C_PI / 2.0));
+            system.Add(wheel);
+            if (texture)
+                wheel->AddAsset(texture);
+            rover.wheels.push_back(wheel);
+        }
+    }
+    rover.numLeftWheels = 3;
+    rover.wheelRadius = p.wheelDia / 2.0;
+
+    //connect wheels to shins -> front wheel on the tibia, middle on the fibula, rear on the rear tibia
+    for (int s = 0; s < 2; s++) {
+        std::shared_ptr<ChBody> carrier[3] = { tibiaF[s], fibulaF[s], tibiaR[s] };
+        for (int w = 0; w < 3; w++) {
+            auto& wheel = rover.wheels[3 * s + w];
+            rover.wheelJoints.push_back(AddRevolute(system, carrier[w], wheel,
+                ChVector<>(wheel->GetPos().x(), wheel->GetPos().y(), wheelJointZ[s])));
+        }
+    }
+
+    //Add springs between tibia and fibulas
+    auto col_1 = std::make_shared<ChColorAsset>();
+    col_1->SetColor(ChColor(0.6f, 0, 0));
+
+    for (int s = 0; s < 2; s++) {
+        ChVector<> frontStart(-((p.tibiaLength - p.tibiaSpringPt) * cos(p.tibiaAngle)),
+            (p.tibiaLength - p.tibiaSpringPt) * sin(p.tibiaAngle), legZ[s]);
+        ChVector<> frontEnd(-(tibX + p.fibulaSpringPt * cos(p.fibulaAngle)),
+            tibY - p.fibulaSpringPt * sin(p.fibulaAngle), legZ[s]);
+        ChVector<> rearStart(-(2.0 * fibX + (p.tibiaLength + p.tibiaSpringPt) * cos(p.tibiaAngle)),
+            (p.tibiaLength - p.tibiaSpringPt) * sin(p.tibiaAngle), legZ[s]);
+        ChVector<> rearEnd(-(tibX + (2.0 * p.fibulaLength - p.fibulaSpringPt) * cos(p.fibulaAngle)),
+            tibY - p.fibulaSpringPt * sin(p.fibulaAngle), legZ[s]);
+
+        std::shared_ptr<ChBody> tibia[2] = { tibiaF[s], tibiaR[s] };
+        std::shared_ptr<ChBody> fibula[2] = { fibulaF[s], fibulaR[s] };
+        ChVector<> start[2] = { frontStart, rearStart };
+        ChVector<> end[2] = { frontEnd, rearEnd };
+
+        for (int i = 0; i < 2; i++) {
+            auto spring = std::make_shared<ChLinkSpring>();
+            spring->Initialize(tibia[i],	// first body to link it with
+                fibula[i],	// second body to link it with
+                false,	// pos absolute
+                start[i], // position of first end of spring
+                end[i], // position of second end of spring
+                false,	// rest length not original length
+                p.restLength);	// rest length
+            system.Add(spring);
+            spring->Set_SpringK(p.k);
+            spring->Set_SpringR(p.c);
+            // Attach a visualization asset.
+            if (p.visualization) {
+                spring->AddAsset(col_1);
+                spring->AddAsset(std::make_shared<ChPointPointSpring>(.0125, 20, 10));
+            }
+            rover.springs.push_back(spring);
+        }
+    }
+
+    //set torque on the wheels
+    rover.SetTorque(p.torqueLeftSide, p.torqueRightSide);
+
+    if (p.filterSelfCollision)
+        SetCollisionFamilies(rover);
+    NameBodies(rover);
+    return rover;
+}
+
+RoverModel BuildRoverA(ChSystem& system, const RoverAParameters& p) {
+    RoverModel rover;
+    double inTom = p.inTom;
+
+    std::shared_ptr<ChTexture> wheelTexture;
+    if (p.visualization) {
+        wheelTexture = std::make_shared<ChTexture>();
+        wheelTexture->SetTextureFilename(GetChronoDataFile("redwhite.png"));  // texture in ../data
+    }
+
+    // ===============================
+    // Create Chassis
+    auto frameBox = std::make_shared<ChBodyEasyBox>(p.chassisL, p.chassisH, p.chassisW,	// x,y,z size
+        100,													// density
+        true,													// collide enable?
+        p.visualization											// visualization?
+        );
+    frameBox->SetMass(p.chassisMass);
+    frameBox->SetPos(ChVector<>(0, 30.*inTom, 0));
+    system.Add(frameBox);
+    rover.chassis = frameBox;
+
+    //frame link layout of one side in inches: center, angle from horizontal, link it pivots on
+    //(-1 = chassis) and pivot point. Components 1 and 2 hang from the frame, 3 and 4 carry the
+    //middle wheel, 5 and 6 carry the front and rear wheels
+    struct LinkLayout {
+        double x, y, angle;
+        int parent;
+        double pivotX, pivotY;
+    };
+    const LinkLayout layout[6] = {
+        { 19.757, 22.652, CH_C_PI / 3., -1, 24., 30. },
+        { -19.757, 22.652, -CH_C_PI / 3., -1, -24., 30. },
+        { 7.757, 11.865, 23.91*CH_C_PI / 180., 0, 15.515, 15.303 },
+        { -7.757, 11.865, -23.91*CH_C_PI / 180., 1, -15.515, 15.303 },
+        { 23.272, 11.865, -23.91*CH_C_PI / 180., 0, 15.515, 15.303 },
+        { -23.272, 11.865, 23.91*CH_C_PI / 180., 1, -15.515, 15.303 },
+    };
+
+    // ===============================
+    // Create the drive system of each side -> right side first, then left side
+    double sideZ[2] = { (36. / 2. + .5)*inTom, -(36. / 2. + .5)*inTom };
+    std::shared_ptr<ChBody> links[2][6];
+    std::shared_ptr<ChBody> wheels[2][3];
+    std::shared_ptr<ChLinkLockRevolute> wheelJoints[2][3];
+    std::shared_ptr<ChLinkLockRevolute> middleWheelJoint[2];
+
+    for (int s = 0; s < 2; s++) {
+        double z = sideZ[s];
+
+        for (int l = 0; l < 6; l++) {
+            auto link = std::make_shared<ChBodyEasyBox>(12.*sqrt(2.)*inTom, 1. * inTom, 1. * inTom,	// x,y,z size
+                100,													// density
+                false,													// collide enable?
+                p.visualization											// visualization?
+                );
+            link->SetMass(p.linkMass);
+            link->SetPos(ChVector<>(layout[l].x*inTom, layout[l].y*inTom, z));
+            link->SetRot(Q_from_AngZ(layout[l].angle));
+            system.Add(link);
+            links[s][l] = link;
+            rover.legs.push_back(link);
+
+            std::shared_ptr<ChBody> parent = layout[l].parent < 0 ? std::shared_ptr<ChBody>(frameBox) : links[s][layout[l].parent];
+            auto pivot = std::make_shared<ChLinkLockRevolute>();
+            //links hanging from the frame are the first body of their pivot
+            if (layout[l].parent < 0)
+                pivot->Initialize(link, parent, ChCoordsys<>(ChVector<>(layout[l].pivotX*inTom, layout[l].pivotY*inTom, z), Q_from_AngY(0)));
+            else
+                pivot->Initialize(parent, link, ChCoordsys<>(ChVector<>(layout[l].pivotX*inTom, layout[l].pivotY*inTom, z), Q_from_AngY(0)));
+            system.Add(pivot);
+            rover.legJoints.push_back(pivot);
+        }
+
+        // add wheels -> front on component 5, middle on components 3 and 4, rear on component 6
+        double wheelX[3] = { 31.029, 0, -31.029 };
+        int carrier[3] = { 4, 2, 5 };
+        for (int w = 0; w < 3; w++) {
+            auto wheel = std::make_shared<ChBodyEasyCylinder>(
+                p.wheelRadius, // radius
+                p.wheelWidth, // height
+                p.wheelDensity,// density
+                true,// collide
+                p.visualization// visualization
+                );
+            wheel->SetPos(ChVector<>(wheelX[w]*inTom, 8.426*inTom, z));
+            wheel->SetRot(Q_from_AngX(CH_C_PI / 2.0));
+            system.Add(wheel);
+            if (wheelTexture)
+                wheel->AddAsset(wheelTexture);
+            wheels[s][w] = wheel;
+
+            //create a revolute joint for the wheel and its link
+            auto joint = std::make_shared<ChLinkLockRevolute>();
+            joint->Initialize(links[s][carrier[w]], wheel, ChCoordsys<>(wheel->GetPos(), Q_from_AngY(0)));
+            system.Add(joint);
+            wheelJoints[s][w] = joint;
+
+            if (w == 1) {
+                middleWheelJoint[s] = std::make_shared<ChLinkLockRevolute>();
+                middleWheelJoint[s]->Initialize(links[s][3], wheel, ChCoordsys<>(wheel->GetPos(), Q_from_AngY(0)));
+                system.Add(middleWheelJoint[s]);
+            }
+        }
+    }
+
+    //model lists the left side first
+    for (int s = 1; s >= 0; s--) {
+        for (int w = 0; w < 3; w++) {
+            rover.wheels.push_back(wheels[s][w]);
+            rover.wheelJoints.push_back(wheelJoints[s][w]);
+        }
+        rover.extraWheelJoints.push_back(std::make_pair((int)rover.wheels.size() - 2, middleWheelJoint[s]));
+    }
+    rover.numLeftWheels = 3;
+    rover.wheelRadius = p.wheelRadius;
+
+    // ===============================
+    auto col_1 = std::make_shared<ChColorAsset>();
+    col_1->SetColor(ChColor(0.6f, 0, 0));
+
+    //spring between two bodies of one side, end points in inches
+    auto addSpring = [&](std::shared_ptr<ChBody> body1, std::shared_ptr<ChBody> body2, double x1, double y1, double x2, double y2,
+                         double z, double restLength, double k, int turns, int resolution) {
+        auto spring = std::make_shared<ChLinkSpring>();
+        spring->Initialize(body1,	// first body to link it with
+            body2,	// second body to link it with
+            false,	// pos absolute
+            ChVector<>(x1*inTom, y1*inTom, z), // position of first end of spring
+            ChVector<>(x2*inTom, y2*inTom, z), // position of second end of spring
+            false,	// rest length not original length
+            restLength);	// rest length
+        system.Add(spring);
+        spring->Set_SpringK(k);
+        spring->Set_SpringR(p.damping_coef);
+        // Attach a visualization asset.
+        if (p.visualization) {
+            spring->AddAsset(col_1);
+            spring->AddAsset(std::make_shared<ChPointPointSpring>(.75*inTom, turns, resolution));
+        }
+        rover.springs.push_back(spring);
+    };
+
+    // Create springs -> right side first, then left side
+    for (int s = 0; s < 2; s++) {
+        double z = sideZ[s];
+        // between elements 1 and 5, and 2 and 6
+        addSpring(links[s][0], links[s][4], 19.757, 20.625, 23.272, 11.865, z, p.restLengthOutside, p.springCoefOutside, 20, 5);
+        addSpring(links[s][1], links[s][5], -19.757, 20.625, -23.272, 11.865, z, p.restLengthOutside, p.springCoefOutside, 20, 5);
+        // between frame and elements 3 and 4
+        addSpring(frameBox, links[s][2], -8., 30., 8., 11.972, z, p.restLengthInside, p.springCoefInside, 40, 15);
+        addSpring(frameBox, links[s][3], 8., 30., -8., 11.972, z, p.restLengthInside, p.springCoefInside, 40, 15);
+    }
+
+    // ===============================
+    // Add motors to wheels
+    rover.SetTorque(p.torqueLeftSide, p.torqueRightSide);
+
+    if (p.filterSelfCollision)
+        SetCollisionFamilies(rover);
+    NameBodies(rover);
+    return rover;
+}
+
+RoverModel BuildRoverC(ChSystem& system, const RoverCParameters& p) {
+    RoverModel rover;
+    const std::vector<ChVector<>>& wheelPos = p.wheelPos;
+    const ChVector<>& bodyPos = p.bodyPos;
+
+    // Add Frame
+    auto frameBox = std::make_shared<ChBodyEasyBox>(p.bodyDims.x(), p.bodyDims.y(), p.bodyDims.z(),	// x,y,z size
+        1000,													// density
+        true,													// collide enable?
+        p.visualization											// visualization?
+        );
+    frameBox->SetMass(p.bodyMass);
+    frameBox->SetPos(bodyPos);
+    system.Add(frameBox);
+    rover.chassis = frameBox;
+
+    //add legs -> one per wheel, from the frame center down to the wheel
+    double legLength = sqrt(wheelPos[0].x()*wheelPos[0].x() + wheelPos[0].y()*wheelPos[0].y());
+
+    auto legColor = std::make_shared<ChColorAsset>();
+    legColor->SetColor(ChColor(0.2f, 0.25f, 0.25f));
+
+    for (size_t i = 0; i < wheelPos.size(); i++) {
+        auto leg = std::make_shared<ChBodyEasyBox>(legLength, p.legVis, p.legVis, 1000, false, p.visualization);
+        leg->SetMass(p.legMass);
+        leg->SetPos(ChVector<>((wheelPos[i].x() + bodyPos.x()) / 2.0, (wheelPos[i].y() + bodyPos.y()) / 2.0, wheelPos[i].z()));
+        leg->SetRot(Q_from_AngZ(-atan2(wheelPos[i].y() + bodyPos.y(), wheelPos[i].x() + bodyPos.x())));
+        system.Add(leg);
+        if (p.visualization)
+            leg->AddAsset(legColor);
+        rover.legs.push_back(leg);
+
+        auto legJoint = std::make_shared<ChLinkLockRevolute>();
+        legJoint->Initialize(frameBox, leg, ChCoordsys<>(ChVector<>(bodyPos.x(), bodyPos.y(), wheelPos[i].z()), Q_from_AngY(0)));
+        system.Add(legJoint);
+        rover.legJoints.push_back(legJoint);
+    }
+
+    //add wheels
+    std::shared_ptr<ChTexture> wheel_texture;
+    if (p.visualization) {
+        wheel_texture = std::make_shared<ChTexture>();
+        wheel_texture->SetTextureFilename(GetChronoDataFile("redwhite.png"));  // texture in ../data
+    }
+
+    for (size_t i = 0; i < wheelPos.size(); i++) {
+        auto wheel = std::make_shared<ChBodyEasyCylinder>(p.wheelRadius, p.wheelWidth, 1000, true, p.visualization);
+        wheel->SetPos(wheelPos[i]);
+        wheel->SetRot(Q_from_AngX(CH_C_PI / 2.0));
+        wheel->SetMass(p.wheelMass);
+        system.Add(wheel);
+        if (wheel_texture)
+            wheel->AddAsset(wheel_texture);
+        rover.wheels.push_back(wheel);
+
+        //create a revolute joint for the wheel and its leg
+        auto wheelJoint = std::make_shared<ChLinkLockRevolute>();
+        wheelJoint->Initialize(rover.legs[i], wheel, ChCoordsys<>(wheelPos[i], Q_from_AngY(0)));
+        system.Add(wheelJoint);
+        rover.wheelJoints.push_back(wheelJoint);
+    }
+    rover.numLeftWheels = 2;
+    rover.wheelRadius = p.wheelRadius;
+
+    //add springs between the front and rear leg of each side, halfway down the legs
+    auto springColor = std::make_shared<ChColorAsset>();
+    springColor->SetColor(ChColor(0.2f, 0.25f, 0.25f));
+
+    for (int s = 0; s < 2; s++) {
+        const ChVector<>& front = wheelPos[2 * s];
+        const ChVector<>& rear = wheelPos[2 * s + 1];
+        auto spring = std::make_shared<ChLinkSpring>();
+        spring->Initialize(rover.legs[2 * s],	// first body to link it with
+            rover.legs[2 * s + 1],	// second body to link it with
+            false,	// pos absolute
+            ChVector<>(front.x() / 2.0, bodyPos.y() / 2.0, front.z()), // position of first end of spring
+            ChVector<>(rear.x() / 2.0, bodyPos.y() / 2.0, rear.z()), // position of second end of spring
+            false,	// rest length not original length
+            p.restLength);	// rest length
+        system.Add(spring);
+        spring->Set_SpringK(p.k);
+        spring->Set_SpringR(p.c);
+        // Attach a visualization asset.
+        if (p.visualization) {
+            spring->AddAsset(springColor);
+            spring->AddAsset(std::make_shared<ChPointPointSpring>(.0125, 20, 10));
+        }
+        rover.springs.push_back(spring);
+    }
+
+    //set torque on the wheels
+    rover.SetTorque(p.torqueLeftSide, p.torqueRightSide);
+
+    if (p.filterSelfCollision)
+        SetCollisionFamilies(rover);
+    NameBodies(rover);
+    return rover;
+}
+
+std::shared_ptr<ChBody> AddFloor(ChSystem& system, double floorTop, double size, double thickness, bool visualization,
+                                 const std::string& texture) {
+    auto floorBody = std::make_shared<ChBodyEasyBox>(size, thickness, size,  // x, y, z dimensions
+                                                     1000,       // density
+                                                     true,      // contact geometry - allow collision
+                                                     visualization        // enable visualization geometry
+                                                     );
+    floorBody->SetPos(ChVector<>(0, floorTop - thickness / 2.0, 0));
+    floorBody->SetBodyFixed(true);
+    system.Add(floorBody);
+    floorBody->SetName("floor");
+
+    // Optionally, attach a texture or a RGB color asset to the floor, for better visualization
+    if (visualization && !texture.empty()) {
+        auto floorTexture = std::make_shared<ChTexture>();
+        floorTexture->SetTextureFilename(GetChronoDataFile(texture));  // texture in ../data
+        floorBody->AddAsset(floorTexture);
+    } else if (visualization) {
+        auto color = std::make_shared<ChColorAsset>();
+        color->SetColor(ChColor(0.2f, 0.25f, 0.25f));
+        floorBody->AddAsset(color);
+    }
+    return floorBody;
+}
+
+static void AddObstacleTexture(std::shared_ptr<ChBody> obstacle) {
+    auto obstacleTexture = std::make_shared<ChTexture>();
+    obstacleTexture->SetTextureFilename(GetChronoDataFile("cubetexture_wood.png"));  // texture in ../data
+    obstacle->AddAsset(obstacleTexture);
+}
+
+std::shared_ptr<ChBody> AddObstacleBox(ChSystem& system, const ChVector<>& size, const ChVector<>& pos, bool visualization,
+                                       double density) {
+    auto obstacle = std::make_shared<ChBodyEasyBox>(size.x(), size.y(), size.z(), density, true, visualization);
+    obstacle->SetPos(pos);
+    system.Add(obstacle);
+    obstacle->SetBodyFixed(true);
+    obstacle->SetName("obstacle");
+
+    if (visualization)
+        AddObstacleTexture(obstacle);
+    return obstacle;
+}
+
+std::shared_ptr<ChBody> AddObstacleCylinder(ChSystem& system, double radius, double length, const ChVector<>& pos,
+                                            bool visualization) {
+    auto obstacle = std::make_shared<ChBodyEasyCylinder>(radius, length, 1000, true, visualization);
+    obstacle->SetPos(pos);
+    obstacle->SetBodyFixed(true);
+    obstacle->SetRot(Q_from_AngX(CH_C_PI / 2.0));
+    system.Add(obstacle);
+    obstacle->SetName("obstacle");
+
+    if (visualization)
+        AddObstacleTexture(obstacle);
+    return obstacle;
+}
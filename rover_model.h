@@ -0,0 +1,210 @@
+// =============================================================================
+// Rover model builder.
+//
+// Builds a rover into any ChSystem from a parameter struct and returns handles
+// to the bodies, joints and springs so callers (interactive apps, headless
+// runs, sweeps) never have to rebuild the model by hand.
+//
+// Robot is oriented with X forward, Y up and Z right.
+// =============================================================================
+
+#ifndef ROVER_MODEL_H
+#define ROVER_MODEL_H
+
+#include "chrono/physics/ChSystem.h"
+#include "chrono/physics/ChBodyEasy.h"
+#include "chrono/physics/ChLinkLock.h"
+#include "chrono/physics/ChLinkSpring.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+//design parameters of the 6 wheel tibia/fibula rover (roverD)
+//Origin is at center of left front wheel
+struct RoverDParameters {
+    double robotWidth = .9144;  //width from center wheel to center wheel
+
+    double wheelWidth = .15;
+    double wheelDia = .2286;
+    double wheelMass = 3;
+    double wheelFriction = .6;  //Chrono's default; a contact uses the smaller friction of its two bodies
+
+    double chassisW = .6096;
+    double chassisL = .6096;
+    double chassisH = .15;
+    double chassisMass = 30;
+
+    //connection points -> all angles are just angles at design configuration. The ride angles will change based on many robot parameters
+
+    //tibia is connector to front and rear wheels (larger bone in shin as it supports more direct weight ;) )
+    double tibiaLength = .3512;
+    double tibiaAngle = 30 * chrono::CH_C_PI / 180.0;  //radians from horizontal
+    double tibiaMass = .25;
+
+    //thigh is connector from knee to chassis. Thigh length is a result of angles and shin lengths
+    double conW = 0.025;  //width of the square tube for thighs and shins -> no need to change this
+    double thighAngle = 30 * chrono::CH_C_PI / 180.0;  //radians from horizontal
+    double thighMass = .25;
+
+    //fibula connects the knee to the middle wheel
+    double fibulaLength = .3512;
+    double fibulaAngle = 30 * chrono::CH_C_PI / 180.0;  //radians from horizontal
+    double fibulaMass = .25;
+
+    //Spring properties
+    double tibiaSpringPt = 0.15;   //distance from knee to spring connection point on fibula
+    double fibulaSpringPt = 0.15;  //distance from knee to spring connection point on tibia
+    double k = 10000;              //spring constant between tibia and fibula
+    double c = 1000;               //damping coefficient between tibia and fibula
+    double restLength = .22;       //rest length of springs
+
+    //Torque values at wheels
+    double torqueLeftSide = 2;
+    double torqueRightSide = 2;
+
+    //attach textures, colors and visualization shapes (not needed for headless runs)
+    bool visualization = true;
+    //keep chassis-wheel and same side wheel-wheel pairs out of collision detection (see RoverCollisionFamily)
+    bool filterSelfCollision = true;
+
+    double ThighLength() const;
+    double RobotLength() const;
+    double RobotMass() const;
+};
+
+//design parameters of the 6 wheel rocker rover with spring loaded frame links (roverA)
+//Origin is at the center of the chassis projected to the ground. The link geometry is fixed
+//in the builder (in inches, as it was measured)
+struct RoverAParameters {
+    double inTom = 1. / 39.3701;	// converting inches to meters
+
+    double chassisL = 48. * inTom;
+    double chassisH = 2. * inTom;
+    double chassisW = 36. * inTom;
+    double chassisMass = 10.0;
+
+    double linkMass = 1.0;  //each of the 6 frame links per side
+
+    double wheelRadius = 6 * inTom;
+    double wheelWidth = 6 * inTom;
+    double wheelDensity = 100;
+
+    double springCoefOutside = 700;
+    double springCoefInside = 3000;
+    double damping_coef = 80;
+    double restLengthOutside = 11 * inTom;	//11.345 is original length
+    double restLengthInside = 26 * inTom;	//21.356 is original length
+
+    double torqueLeftSide = 1.;
+    double torqueRightSide = 1.;
+
+    bool visualization = true;
+    bool filterSelfCollision = true;
+};
+
+//design parameters of the 4 wheel rover with one spring per side between the legs (roverC)
+//Origin is at the center of the chassis projected to the wheel axles
+struct RoverCParameters {
+    double in2m = .0254;
+
+    //wheel parameters -> front left, rear left, front right, rear right
+    std::vector<chrono::ChVector<>> wheelPos = { {24*in2m, 0, -16*in2m},{-24*in2m, 0, -16*in2m} ,{24*in2m, 0, 16*in2m} ,{-24*in2m, 0, 16*in2m} };
+    double wheelMass = 2;
+    double wheelWidth = 5 * in2m;
+    double wheelRadius = 4 * in2m;
+
+    //leg parameters
+    double legMass = 1;
+    double legVis = 1 * in2m;
+
+    //body parameters
+    chrono::ChVector<> bodyDims = { 24 * in2m, 6 * in2m, 16 * in2m };
+    chrono::ChVector<> bodyPos = { 0,12 * in2m,0 };
+    double bodyMass = 10;
+
+    //spring parameters -> springs attach halfway down the legs
+    double k = 5000;
+    double c = 500;
+    double restLength = 21.5 * in2m;
+
+    //torques
+    double torqueLeftSide = 2;
+    double torqueRightSide = 2;
+
+    bool visualization = true;
+    bool filterSelfCollision = true;
+};
+
+//collision families the builders put the rover in when filterSelfCollision is set. The chassis does
+//not collide with any wheel, and wheels do not collide with wheels of the same side; everything else
+//(floor, obstacles in the default family 0) still collides with all of them. Families are per
+//system, so with several rovers in one system the same pairs between different rovers would be
+//skipped too -> only set filterSelfCollision for a rover that is alone in its system (see fleet.h).
+enum RoverCollisionFamily {
+    ROVER_FAMILY_CHASSIS = 1,
+    ROVER_FAMILY_LEFT_WHEELS = 2,
+    ROVER_FAMILY_RIGHT_WHEELS = 3
+};
+
+//handles to everything the builder created
+struct RoverModel {
+    std::shared_ptr<chrono::ChBody> chassis;
+
+    //wheels[0..numLeftWheels) are on the left side, front to rear, the rest on the right side
+    std::vector<std::shared_ptr<chrono::ChBody>> wheels;
+    std::vector<std::shared_ptr<chrono::ChLinkLockRevolute>> wheelJoints;  //one per wheel, same order
+    int numLeftWheels = 0;
+    double wheelRadius = 0;  //same for every wheel
+
+    //wheels carried by two links (roverA middle wheels) have a second revolute joint. It is driven
+    //like the first one. Paired with the index of its wheel.
+    std::vector<std::pair<int, std::shared_ptr<chrono::ChLinkLockRevolute>>> extraWheelJoints;
+
+    //suspension links (thighs, shins, ...) and the joints between them and the chassis
+    std::vector<std::shared_ptr<chrono::ChBody>> legs;
+    std::vector<std::shared_ptr<chrono::ChLinkLockRevolute>> legJoints;
+    std::vector<std::shared_ptr<chrono::ChLinkSpring>> springs;
+
+    //apply a constant motor torque to every wheel of each side
+    void SetTorque(double left, double right);
+
+    //move every body of the rover by offset. Joints and springs are attached in body coordinates
+    //and move along. Only before the first step.
+    void Translate(const chrono::ChVector<>& offset);
+};
+
+//add the 6 wheel tibia/fibula rover to the system
+RoverModel BuildRoverD(chrono::ChSystem& system, const RoverDParameters& params);
+
+//add the 6 wheel rocker rover to the system
+RoverModel BuildRoverA(chrono::ChSystem& system, const RoverAParameters& params);
+
+//add the 4 wheel rover to the system
+RoverModel BuildRoverC(chrono::ChSystem& system, const RoverCParameters& params);
+
+//fixed floor box whose top face is at floorTop. Colored gray unless a texture file
+//from the Chrono data directory is given
+std::shared_ptr<chrono::ChBody> AddFloor(chrono::ChSystem& system,
+                                         double floorTop,
+                                         double size = 100,
+                                         double thickness = 2,
+                                         bool visualization = true,
+                                         const std::string& texture = "");
+
+//fixed box obstacle centered at pos
+std::shared_ptr<chrono::ChBody> AddObstacleBox(chrono::ChSystem& system,
+                                               const chrono::ChVector<>& size,
+                                               const chrono::ChVector<>& pos,
+                                               bool visualization = true,
+                                               double density = 1000);
+
+//fixed cylinder obstacle lying across the path (axis along Z) centered at pos
+std::shared_ptr<chrono::ChBody> AddObstacleCylinder(chrono::ChSystem& system,
+                                                    double radius,
+                                                    double length,
+                                                    const chrono::ChVector<>& pos,
+                                                    bool visualization = true);
+
+#endif
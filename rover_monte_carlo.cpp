@@ -0,0 +1,183 @@
+// =============================================================================
+// Monte Carlo study of the roverD obstacle climb under parameter uncertainty.
+//
+// usage: roverD_montecarlo <distribution file> <runs> [--seed n] [--threads n]
+//                          [--duration s] [--step s] [--pose-cache dir]
+//                          [--results file.csv] [--run r]
+//
+// Every run samples the parameters in the distribution file (see
+// monte_carlo.h) from its own seed and runs the roverD scene headless on a
+// work-stealing thread pool. As runs finish, their results go into streaming
+// statistics (see streaming_stats.h): the climb success rate, max pitch over
+// all runs and time to clear the obstacle over the runs that cleared it.
+// Progress lines show the statistics so far; nothing per run is kept in
+// memory. --results appends one row per run (seed, sampled values, result)
+// to a CSV file as it finishes. --run r repeats only run r of the study with
+// the same seed and prints its parameters and result.
+// =============================================================================
+
+#include "monte_carlo.h"
+#include "rover_run.h"
+#include "streaming_stats.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace chrono;
+
+//aggregate of every finished run
+struct StudyStats {
+    long runs = 0;
+    long cleared = 0;
+    StreamingSummary maxPitch;
+    StreamingSummary timeToClear;  //cleared runs only
+    StreamingSummary distance;
+
+    void Add(const RunResult& result) {
+        runs++;
+        maxPitch.Add(result.maxPitch);
+        distance.Add(result.distance);
+        if (result.timeToClear >= 0) {
+            cleared++;
+            timeToClear.Add(result.timeToClear);
+        }
+    }
+
+    void Print(std::ostream& out) const {
+        //Wilson score interval of the success rate
+        double n = (double)std::max(runs, 1L);
+        double rate = cleared / n;
+        double z = 1.96;
+        double center = (rate + z * z / (2 * n)) / (1 + z * z / n);
+        double halfWidth = z * sqrt(rate * (1 - rate) / n + z * z / (4 * n * n)) / (1 + z * z / n);
+        out << "CLIMB SUCCESS: " << cleared << "/" << runs << " = " << rate * 100 << "% (95% interval "
+            << std::max(0.0, center - halfWidth) * 100 << " - " << std::min(1.0, center + halfWidth) * 100 << "%)"
+            << std::endl;
+        out << "MAX PITCH (deg): ";
+        maxPitch.Print(out);
+        out << std::endl << "TIME TO CLEAR (s): ";
+        if (cleared > 0)
+            timeToClear.Print(out);
+        else
+            out << "no run cleared the obstacle";
+        out << std::endl << "DISTANCE (m): ";
+        distance.Print(out);
+        out << std::endl;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    SetChronoDataPath(CHRONO_DATA_DIR);
+
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <distribution file> <runs> [--seed n] [--threads n] [--duration s]"
+                  << " [--step s] [--pose-cache dir] [--results file.csv] [--run r]" << std::endl;
+        return 1;
+    }
+
+    long numRuns = atol(argv[2]);
+    RunSettings settings;
+    uint64_t studySeed = 1;
+    unsigned numThreads = 0;
+    std::string resultsPath;
+    long onlyRun = -1;
+    for (int i = 3; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0)
+            studySeed = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--threads") == 0)
+            numThreads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--duration") == 0)
+            settings.duration = atof(argv[++i]);
+        else if (strcmp(argv[i], "--step") == 0)
+            settings.step_size = atof(argv[++i]);
+        else if (strcmp(argv[i], "--pose-cache") == 0)
+            settings.poseCache = argv[++i];
+        else if (strcmp(argv[i], "--results") == 0)
+            resultsPath = argv[++i];
+        else if (strcmp(argv[i], "--run") == 0)
+            onlyRun = atol(argv[++i]);
+    }
+    if (numRuns <= 0) {
+        std::cerr << "Number of runs must be positive" << std::endl;
+        return 1;
+    }
+
+    std::vector<ParameterDistribution> distributions;
+    if (!ReadDistributions(argv[1], distributions))
+        return 1;
+
+    //reproduce a single run
+    if (onlyRun >= 0) {
+        uint64_t seed = RunSeed(studySeed, (uint64_t)onlyRun);
+        std::vector<double> values;
+        RoverDParameters params = SampleRoverD(distributions, seed, values);
+        std::cout << "Run " << onlyRun << " of study seed " << studySeed << " (run seed " << seed << ")" << std::endl;
+        for (size_t d = 0; d < distributions.size(); d++)
+            std::cout << "  " << distributions[d].name << " = " << values[d] << std::endl;
+        RunResult result = RunRoverD(params, settings);
+        RunResult::WriteCsvHeader(std::cout);
+        std::cout << std::endl;
+        result.WriteCsv(std::cout);
+        std::cout << std::endl;
+        return 0;
+    }
+
+    std::ofstream results;
+    if (!resultsPath.empty()) {
+        results.open(resultsPath);
+        if (!results) {
+            std::cerr << "Could not open " << resultsPath << std::endl;
+            return 1;
+        }
+        results << "run,seed";
+        for (const auto& distribution : distributions)
+            results << ',' << distribution.name;
+        results << ',';
+        RunResult::WriteCsvHeader(results);
+        results << std::endl;
+    }
+
+    WorkStealingPool pool(numThreads);
+    std::cout << "Monte Carlo: " << numRuns << " runs of " << settings.duration << " s, seed " << studySeed << ", "
+              << distributions.size() << " sampled parameters on " << pool.Size() << " threads" << std::endl;
+
+    std::mutex statsMutex;
+    StudyStats stats;
+    long reportEvery = std::max(1L, numRuns / 20);
+
+    for (long r = 0; r < numRuns; r++) {
+        pool.Submit([&, r]() {
+            uint64_t seed = RunSeed(studySeed, (uint64_t)r);
+            std::vector<double> values;
+            RoverDParameters params = SampleRoverD(distributions, seed, values);
+
+            RunResult result = RunRoverD(params, settings);
+
+            std::lock_guard<std::mutex> lock(statsMutex);
+            stats.Add(result);
+            if (results.is_open()) {
+                results << r << ',' << seed;
+                for (double value : values)
+                    results << ',' << value;
+                results << ',';
+                result.WriteCsv(results);
+                results << std::endl;
+            }
+            if (stats.runs % reportEvery == 0 && stats.runs < numRuns)
+                std::cout << stats.runs << "/" << numRuns << " runs, " << stats.cleared << " cleared, max pitch p50 "
+                          << stats.maxPitch.P50() << " p95 " << stats.maxPitch.P95() << std::endl;
+        });
+    }
+    pool.Wait();
+
+    stats.Print(std::cout);
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include "rover_run.h"
+#include "adaptive_step.h"
+#include "checkpoint.h"
+#include "pose_cache.h"
+#include "solver_stats.h"
+#include "spring_telemetry.h"
+#include "wheel_contacts.h"
+
+#include "chrono/physics/ChSystemNSC.h"
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+
+using namespace chrono;
+
+struct NamedParameter {
+    const char* name;
+    double RoverDParameters::*field;
+    double scale;  //file units -> field units
+};
+
+static const NamedParameter namedParameters[] = {
+    { "robotWidth", &RoverDParameters::robotWidth, 1 },
+    { "wheelWidth", &RoverDParameters::wheelWidth, 1 },
+    { "wheelDia", &RoverDParameters::wheelDia, 1 },
+    { "wheelMass", &RoverDParameters::wheelMass, 1 },
+    { "wheelFriction", &RoverDParameters::wheelFriction, 1 },
+    { "chassisW", &RoverDParameters::chassisW, 1 },
+    { "chassisL", &RoverDParameters::chassisL, 1 },
+    { "chassisH", &RoverDParameters::chassisH, 1 },
+    { "chassisMass", &RoverDParameters::chassisMass, 1 },
+    { "tibiaLength", &RoverDParameters::tibiaLength, 1 },
+    { "tibiaAngle", &RoverDParameters::tibiaAngle, CH_C_PI / 180.0 },
+    { "tibiaMass", &RoverDParameters::tibiaMass, 1 },
+    { "thighAngle", &RoverDParameters::thighAngle, CH_C_PI / 180.0 },
+    { "thighMass", &RoverDParameters::thighMass, 1 },
+    { "fibulaLength", &RoverDParameters::fibulaLength, 1 },
+    { "fibulaAngle", &RoverDParameters::fibulaAngle, CH_C_PI / 180.0 },
+    { "fibulaMass", &RoverDParameters::fibulaMass, 1 },
+    { "tibiaSpringPt", &RoverDParameters::tibiaSpringPt, 1 },
+    { "fibulaSpringPt", &RoverDParameters::fibulaSpringPt, 1 },
+    { "k", &RoverDParameters::k, 1 },
+    { "c", &RoverDParameters::c, 1 },
+    { "restLength", &RoverDParameters::restLength, 1 },
+    { "torqueLeftSide", &RoverDParameters::torqueLeftSide, 1 },
+    { "torqueRightSide", &RoverDParameters::torqueRightSide, 1 },
+};
+
+bool SetRoverDParameter(RoverDParameters& params, const std::string& name, double value) {
+    for (const auto& named : namedParameters) {
+        if (name == named.name) {
+            params.*named.field = value * named.scale;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GetRoverDParameter(const RoverDParameters& params, const std::string& name, double& value) {
+    for (const auto& named : namedParameters) {
+        if (name == named.name) {
+            value = params.*named.field / named.scale;
+            return true;
+        }
+    }
+    return false;
+}
+
+void RunResult::WriteCsvHeader(std::ostream& out) {
+    out << "steps,sim_time,wall_time,final_x,distance,max_pitch_deg,min_chassis_y,time_to_clear,mean_iters,p99_iters,max_iters";
+    for (int w = 0; w < numWheels; w++)
+        out << ",wheel_load_" << w;
+    out << ",max_wheel_load,slip_rms,peak_spring_force,max_spring_deflection,damper_energy";
+}
+
+void RunResult::WriteCsv(std::ostream& out) const {
+    out << steps << ',' << simTime << ',' << wallTime << ',' << finalX << ',' << distance << ','
+        << maxPitch << ',' << minChassisY << ',' << timeToClear << ',' << meanIters << ',' << p99Iters << ','
+        << maxIters;
+    for (int w = 0; w < numWheels; w++)
+        out << ',' << meanWheelLoad[w];
+    out << ',' << maxWheelLoad << ',' << slipRms << ',' << peakSpringForce << ',' << maxSpringDeflection << ','
+        << damperEnergy;
+}
+
+double ChassisPitch(const ChBody& chassis) {
+    ChVector<> forward = chassis.GetRot().Rotate(ChVector<>(1, 0, 0));
+    return asin(std::max(-1.0, std::min(1.0, forward.y())));
+}
+
+RoverModel BuildRoverDScene(ChSystem& system, const RoverDParameters& params, const RunSettings& settings) {
+    RoverDParameters p = params;
+    p.visualization = false;
+
+    //ground friction above any sensible wheelFriction -> the wheels' friction decides every wheel contact
+    auto floor = AddFloor(system, settings.floorTop, 100, 2, false);
+    floor->GetMaterialSurfaceNSC()->SetFriction(1.0f);
+    RoverModel rover = BuildRoverD(system, p);
+    auto obstacle = AddObstacleBox(system, settings.obstacleSize, settings.obstaclePos, false);
+    obstacle->GetMaterialSurfaceNSC()->SetFriction(1.0f);
+    return rover;
+}
+
+RunResult RunRoverD(const RoverDParameters& p, const RunSettings& settings) {
+    ChSystemNSC system;
+    system.SetMaxItersSolverSpeed(settings.maxIters);
+
+    RoverModel rover = BuildRoverDScene(system, p, settings);
+
+    RunResult result;
+    if (!settings.checkpoint.empty()) {
+        if (!LoadCheckpoint(system, settings.checkpoint))
+            return result;
+    } else if (!settings.poseCache.empty()) {
+        SeedSettledRoverD(system, rover, p, settings.floorTop, settings.poseCache);
+    }
+
+    double obstacleEnd = settings.obstaclePos.x() + settings.obstacleSize.x() / 2.0;
+    double startX = rover.chassis->GetPos().x();
+
+    result.minChassisY = rover.chassis->GetPos().y();
+
+    AdaptiveStepSettings stepSettings;
+    stepSettings.minStep = settings.minStep;
+    stepSettings.maxStep = settings.maxStep;
+    stepSettings.initialStep = settings.step_size;
+    AdaptiveStepper stepper(system, stepSettings);
+    SolverStats solverStats(system, settings.solverTolerance, settings.solverStats);
+    WheelContactSettings contactSettings;
+    contactSettings.keepHistory = false;  //statistics only
+    WheelContacts wheelContacts(system, rover, contactSettings);
+    SpringTelemetrySettings springSettings;
+    springSettings.keepHistory = false;
+    SpringTelemetry springTelemetry(rover.springs, springSettings);
+    stepper.WatchSprings(rover.springs);
+    double endMargin = 0.5 * (settings.adaptive ? settings.minStep : settings.step_size);
+    double endTime = system.GetChTime() + settings.duration;
+
+    auto wallStart = std::chrono::steady_clock::now();
+    while (system.GetChTime() < endTime - endMargin) {
+        if (settings.adaptive)
+            stepper.AdvanceTo(std::min(endTime, system.GetChTime() + stepper.CurrentStep()));
+        else
+            system.DoStepDynamics(settings.step_size);
+        solverStats.Record();
+        wheelContacts.Record();
+        springTelemetry.Record(system.GetChTime());
+        result.steps++;
+
+        result.maxPitch = std::max(result.maxPitch, fabs(ChassisPitch(*rover.chassis)));
+        result.minChassisY = std::min(result.minChassisY, rover.chassis->GetPos().y());
+
+        if (result.timeToClear < 0) {
+            bool cleared = true;
+            for (auto& wheel : rover.wheels)
+                cleared = cleared && wheel->GetPos().x() - p.wheelDia / 2.0 > obstacleEnd;
+            if (cleared)
+                result.timeToClear = system.GetChTime();
+        }
+    }
+    result.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    result.simTime = system.GetChTime();
+    result.finalX = rover.chassis->GetPos().x();
+    result.distance = result.finalX - startX;
+    result.maxPitch *= 180.0 / CH_C_PI;
+
+    SolverStatSummary iters = solverStats.IterationSummary();
+    result.meanIters = iters.mean;
+    result.p99Iters = iters.p99;
+    result.maxIters = iters.max;
+
+    double slipSquares = 0;
+    size_t slipCount = 0;
+    for (int w = 0; w < std::min(wheelContacts.NumWheels(), (int)RunResult::numWheels); w++) {
+        const WheelContactSummary& summary = wheelContacts.Summary(w);
+        result.meanWheelLoad[w] = summary.normalForce.Mean();
+        result.maxWheelLoad = std::max(result.maxWheelLoad, summary.normalForce.Max());
+        slipSquares += summary.slip.Rms() * summary.slip.Rms() * summary.slip.Count();
+        slipCount += summary.slip.Count();
+    }
+    result.slipRms = slipCount > 0 ? sqrt(slipSquares / slipCount) : 0;
+
+    result.peakSpringForce = springTelemetry.PeakForce();
+    for (size_t s = 0; s < springTelemetry.NumSprings(); s++) {
+        const SpringSummary& summary = springTelemetry.Summary(s);
+        result.maxSpringDeflection =
+            std::max(result.maxSpringDeflection, std::max(fabs(summary.deflection.Min()), fabs(summary.deflection.Max())));
+        result.damperEnergy += summary.dampedEnergy;
+    }
+    return result;
+}
@@ -0,0 +1,90 @@
+// =============================================================================
+// Headless roverD scenario runs for batch tools (sweeps, studies).
+//
+// Every run builds its own ChSystemNSC, so runs are independent and can be
+// executed on any number of threads at once.
+// =============================================================================
+
+#ifndef ROVER_RUN_H
+#define ROVER_RUN_H
+
+#include "rover_model.h"
+
+#include <ostream>
+#include <string>
+
+//scenario shared by every run of a batch
+struct RunSettings {
+    double duration = 10.0;    //sim seconds per run (after the checkpoint time, if any)
+    double step_size = 0.001;
+    int maxIters = 5000;       //SetMaxItersSolverSpeed
+    double solverTolerance = 0;  //> 0 -> speed solver stops on this residual (see solver_stats.h)
+    //record the speed solver iterations (mean_iters, p99_iters, max_iters, 0 otherwise). Makes Chrono
+    //keep the residual of every solver iteration, so off unless asked for.
+    bool solverStats = false;
+
+    //adaptive stepping between minStep and maxStep (see adaptive_step.h) instead of step_size
+    bool adaptive = false;
+    double minStep = 0.0002;
+    double maxStep = 0.004;
+
+    //same scene as roverD: floor top at y = -.3 and one box obstacle
+    double floorTop = -.3;
+    chrono::ChVector<> obstacleSize = chrono::ChVector<>(.2, .1, 1.22);
+    chrono::ChVector<> obstaclePos = chrono::ChVector<>(2.0, -.3, 0);
+
+    //start every run from this checkpoint (see checkpoint.h) instead of dropping the rover
+    std::string checkpoint;
+    //or from the settled pose cached for the run's parameters in this directory (see pose_cache.h)
+    std::string poseCache;
+};
+
+//summary of one run
+struct RunResult {
+    long steps = 0;
+    double simTime = 0;
+    double wallTime = 0;
+
+    double finalX = 0;          //chassis position at the end of the run
+    double distance = 0;        //chassis travel along X
+    double maxPitch = 0;        //largest |chassis pitch|, degrees
+    double minChassisY = 0;     //lowest chassis height seen
+    double timeToClear = -1;    //sim time at which every wheel was past the obstacle, -1 if never
+
+    //speed solver iterations per step
+    double meanIters = 0;
+    double p99Iters = 0;
+    double maxIters = 0;
+
+    //wheel loads (see wheel_contacts.h), left front to rear then right front to rear
+    static const int numWheels = 6;
+    double meanWheelLoad[numWheels] = {};  //N
+    double maxWheelLoad = 0;    //largest normal force on any wheel in any step, N
+    double slipRms = 0;         //RMS slip ratio of the wheels while in contact
+
+    //suspension springs (see spring_telemetry.h)
+    double peakSpringForce = 0;       //largest |force| of any spring, N
+    double maxSpringDeflection = 0;   //largest |deflection from rest| of any spring, m
+    double damperEnergy = 0;          //dissipated by all dampers, J
+
+    static void WriteCsvHeader(std::ostream& out);
+    void WriteCsv(std::ostream& out) const;
+};
+
+//set/get a RoverDParameters field by name, e.g. "tibiaLength" or "k".
+//Angle fields (tibiaAngle, thighAngle, fibulaAngle) are read and written in degrees.
+//Return false for unknown names.
+bool SetRoverDParameter(RoverDParameters& params, const std::string& name, double value);
+bool GetRoverDParameter(const RoverDParameters& params, const std::string& name, double& value);
+
+//add floor, rover and obstacle (in that order) without visualization
+RoverModel BuildRoverDScene(chrono::ChSystem& system, const RoverDParameters& params, const RunSettings& settings);
+
+//build the scene, restore settings.checkpoint if set, then step for settings.duration.
+//A checkpoint that cannot be restored gives a result with 0 steps.
+RunResult RunRoverD(const RoverDParameters& params, const RunSettings& settings);
+
+//chassis pitch (rotation about Z) in radians
+double ChassisPitch(const chrono::ChBody& chassis);
+
+#endif
@@ -0,0 +1,164 @@
+// =============================================================================
+// Quasi-static screening of roverD designs over a terrain profile.
+//
+// usage: roverD_screen <sweep file> <results.csv> [--profile terrain.csv]
+//                      [--from x] [--to x] [--dx m] [--trace file]
+//
+// Reads the same sweep files as roverD_sweep (see sweep_spec.h) but solves
+// every design with the reduced order model in quasi_static.h instead of
+// stepping the multibody system, so thousands of designs take seconds. Use
+// it to throw out designs that lift a wheel, bottom out or pitch too far
+// before running the survivors through roverD_sweep.
+//
+// Without --profile the terrain is the roverD floor and box obstacle. The
+// rover rolls from --from to --to (default: until the rear wheel is past the
+// end of the profile) in --dx steps. --trace writes every solved pose.
+// =============================================================================
+
+#include "quasi_static.h"
+#include "rover_run.h"
+#include "sweep_spec.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+using namespace chrono;
+
+//worst case of one design over the traverse
+struct ScreenResult {
+    double maxPitch = 0;        //largest |pitch|, degrees
+    double minClearance = 1e30;
+    double minWheelLoad = 1e30; //0 -> a wheel lifted off
+    double maxWheelLoad = 0;
+    double maxSpringForce = 0;  //largest |spring force|
+    int poses = 0;
+    int notConverged = 0;
+    double solveTime = 0;       //wall seconds for the whole traverse
+};
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <sweep file> <results.csv> [--profile terrain.csv]"
+                  << " [--from x] [--to x] [--dx m] [--trace file]" << std::endl;
+        return 1;
+    }
+
+    std::string profilePath, tracePath;
+    double from = 0, to = -1, dx = .01;
+    for (int i = 3; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0)
+            profilePath = argv[++i];
+        else if (strcmp(argv[i], "--from") == 0)
+            from = atof(argv[++i]);
+        else if (strcmp(argv[i], "--to") == 0)
+            to = atof(argv[++i]);
+        else if (strcmp(argv[i], "--dx") == 0)
+            dx = atof(argv[++i]);
+        else if (strcmp(argv[i], "--trace") == 0)
+            tracePath = argv[++i];
+    }
+    if (dx <= 0) {
+        std::cerr << "--dx must be positive" << std::endl;
+        return 1;
+    }
+
+    SweepSpec spec;
+    if (!ReadSweepSpec(argv[1], spec))
+        return 1;
+
+    TerrainProfile profile;
+    if (profilePath.empty()) {
+        RunSettings scene;
+        profile = TerrainProfile::FloorWithBox(scene.floorTop, scene.obstacleSize, scene.obstaclePos);
+    } else if (!profile.Load(profilePath)) {
+        return 1;
+    }
+
+    std::ofstream results(argv[2]);
+    if (!results) {
+        std::cerr << "Could not open " << argv[2] << std::endl;
+        return 1;
+    }
+    results << "run";
+    for (const auto& name : spec.names)
+        results << ',' << name;
+    results << ",max_pitch_deg,min_clearance,min_wheel_load,max_wheel_load,max_spring_force,poses,not_converged,solve_ms"
+            << std::endl;
+
+    std::ofstream trace;
+    if (!tracePath.empty()) {
+        trace.open(tracePath);
+        if (!trace) {
+            std::cerr << "Could not open " << tracePath << std::endl;
+            return 1;
+        }
+        trace << "run,offset,hip_x,hip_y,clearance,pitch_deg,load_front,load_middle,load_rear,"
+              << "spring_front,spring_rear,converged" << std::endl;
+    }
+
+    std::cout << "Screening " << spec.runs.size() << " designs" << std::endl;
+    double totalTime = 0;
+    size_t rejected = 0;
+
+    for (size_t r = 0; r < spec.runs.size(); r++) {
+        RoverDParameters params = spec.Parameters(r);
+        RoverDQuasiStatic model(params);
+
+        //roll until the rear wheel is past the end of the profile
+        double end = to;
+        if (end < 0)
+            end = profile.MaxX() + model.WheelBase() + params.wheelDia;
+
+        auto wallStart = std::chrono::steady_clock::now();
+        std::vector<QuasiStaticState> states = model.Traverse(profile, from, end, dx);
+        ScreenResult result;
+        result.solveTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+        totalTime += result.solveTime;
+
+        result.poses = (int)states.size();
+        for (const QuasiStaticState& state : states) {
+            if (trace.is_open())
+                trace << r << ',' << state.offset << ',' << state.hipX << ',' << state.hipHeight << ','
+                      << state.clearance << ',' << state.pitch << ',' << state.wheelLoad[0] << ','
+                      << state.wheelLoad[1] << ',' << state.wheelLoad[2] << ',' << state.springForce[0] << ','
+                      << state.springForce[1] << ',' << state.converged << '\n';
+            if (!state.converged) {
+                result.notConverged++;
+                continue;
+            }
+            result.maxPitch = std::max(result.maxPitch, fabs(state.pitch));
+            result.minClearance = std::min(result.minClearance, state.clearance);
+            for (int w = 0; w < 3; w++) {
+                result.minWheelLoad = std::min(result.minWheelLoad, state.wheelLoad[w]);
+                result.maxWheelLoad = std::max(result.maxWheelLoad, state.wheelLoad[w]);
+            }
+            for (int s = 0; s < 2; s++)
+                result.maxSpringForce = std::max(result.maxSpringForce, fabs(state.springForce[s]));
+        }
+        if (result.notConverged == result.poses) {
+            result.minClearance = result.minWheelLoad = 0;
+            rejected++;
+        }
+
+        results << r;
+        for (double value : spec.runs[r])
+            results << ',' << value;
+        results << ',' << result.maxPitch << ',' << result.minClearance << ',' << result.minWheelLoad << ','
+                << result.maxWheelLoad << ',' << result.maxSpringForce << ',' << result.poses << ','
+                << result.notConverged << ',' << result.solveTime * 1000 << std::endl;
+    }
+
+    std::cout << "Screened " << spec.runs.size() << " designs in " << totalTime << " s ("
+              << (spec.runs.empty() ? 0 : totalTime * 1000 / spec.runs.size()) << " ms per design)";
+    if (rejected > 0)
+        std::cout << ", " << rejected << " without a single converged pose";
+    std::cout << std::endl;
+    return 0;
+}
@@ -20,6 +20,10 @@
 #include "chrono/assets/ChColorAsset.h"
 #include "chrono_irrlicht/ChIrrApp.h"
 
+#include "telemetry.h"
+
+#include <cstring>
+
 // Use the namespace of Chrono
 
 using namespace chrono;
@@ -121,6 +125,14 @@ int main(int argc, char* argv[]) {
     application.SetTimestep(0.005);
     application.SetTryRealtime(false);
 
+	// Per-step records go through the telemetry ring -> optional CSV with --telemetry <file>
+	std::string telemetryFile;
+	for (int a = 1; a + 1 < argc; a++)
+		if (strcmp(argv[a], "--telemetry") == 0)
+			telemetryFile = argv[a + 1];
+	TelemetryWriter telemetry(telemetryFile);
+	telemetry.SetSources(pendulumBody, {});
+
     //
     // THE SOFT-REAL-TIME CYCLE
     //
@@ -132,11 +144,13 @@ int main(int argc, char* argv[]) {
 
         // This performs the integration timestep!
         application.DoStep();
-		std::cout << "Step number" << i << std::endl;
+		telemetry.Record(i, mphysicalSystem.GetChTime());
 
 		i++;
         application.EndScene();
     }
 
+	telemetry.Stop();
+
     return 0;
 }
@@ -21,8 +21,16 @@
 #include "chrono_irrlicht/ChIrrApp.h"
 #include "chrono/assets/ChPointPointDrawing.h"
 
+#include "render_control.h"
+#include "rover_model.h"
+#include "solver_stats.h"
+#include "drive_commands.h"
+#include "spring_telemetry.h"
 
 #include <math.h>
+#include <cstring>
+#include <fstream>
+#include <iostream>
 
 
 double ftTom = 1 / 3.3;
@@ -41,35 +49,9 @@ using namespace irr::video;
 using namespace irr::io;
 using namespace irr::gui;
 
-double in2m = .0254;
-
-//wheel parameters
-std::vector<ChVector<>> wheelPos = { {24*in2m, 0, -16*in2m},{-24*in2m, 0, -16*in2m} ,{24*in2m, 0, 16*in2m} ,{-24*in2m, 0, 16*in2m} };
-double wheelMass = 2;
-double wheelWidth = 5 * in2m;
-double wheelRadius = 4 * in2m;
-
-//leg parameters
-double legMass = 1;
-double legVis = 1 * in2m;
-
-//body parameters
-std::vector<double> bodyDims = { 24 * in2m, 6 * in2m, 16 * in2m };
-ChVector<> bodyPos = { 0,12 * in2m,0 };
-double bodyMass = 10;
-
-//spring parameters
-double k = 5000;
-double c = 500;
-ChVector<> springStartLeft = {wheelPos[0].x()/2.0,bodyPos.y()/2.0,wheelPos[0].z()};
-ChVector<> springEndLeft = { wheelPos[1].x() / 2.0,bodyPos.y() / 2.0,wheelPos[1].z() };
-ChVector<> springStartRight = { wheelPos[2].x() / 2.0,bodyPos.y() / 2.0,wheelPos[2].z() };
-ChVector<> springEndRight = { wheelPos[3].x() / 2.0,bodyPos.y() / 2.0,wheelPos[3].z() };
-double restLength = 21.5 * in2m;
-
-//torques
-double torqueLeftSide = 2;
-double torqueRightSide = 2;
+//Robot parameters -> see RoverCParameters (rover_model.h)
+RoverCParameters roverParams;
+double in2m = roverParams.in2m;
 
 
 int main(int argc, char* argv[]) {
@@ -79,9 +61,13 @@ int main(int argc, char* argv[]) {
     // Create a Chrono physical system
     ChSystemNSC mphysicalSystem;
 
+    // With --threaded, Irrlicht draws proxies in a display system while physics steps on its own thread
+    ChSystemNSC displaySystem;
+
     // Create the Irrlicht visualization (open the Irrlicht device,
     // bind a simple user interface, etc. etc.)
-    ChIrrApp application(&mphysicalSystem, L"A simple project template", core::dimension2d<u32>(1280,920),
+    ChIrrApp application(RenderControl::IsThreaded(argc, argv) ? &displaySystem : &mphysicalSystem,
+                         L"A simple project template", core::dimension2d<u32>(1280,920),
                          false);  // screen dimensions
 
     // Easy shortcuts to add camera, lights, logo and sky in Irrlicht scene:
@@ -93,226 +79,26 @@ int main(int argc, char* argv[]) {
 
     //======================================================================
 
-    auto floorBody = std::make_shared<ChBodyEasyBox>(100, 2, 100,  // x, y, z dimensions
-                                                     1000,       // density
-                                                     true,      // contact geometry - allow collision
-                                                     true        // enable visualization geometry
-                                                     );
-    floorBody->SetPos(ChVector<>(0, -1.5, 0));
-    floorBody->SetBodyFixed(true);
-    mphysicalSystem.Add(floorBody);
-	// Optionally, attach a RGB color asset to the floor, for better visualization
-	auto color = std::make_shared<ChColorAsset>();
-	color->SetColor(ChColor(0.2f, 0.25f, 0.25f));
-	floorBody->AddAsset(color);
+    auto floorBody = AddFloor(mphysicalSystem, -.5);
 
 
 	//------------------------START 4 WHEELED ROVER-------------------------------------//
-
-
-	// Add Frame
-	auto frameBox = std::make_shared<ChBodyEasyBox>(bodyDims[0],bodyDims[1],bodyDims[2],	// x,y,z size
-		1000,													// density
-		true,													// collide enable?
-		true													// visualization?		
-		);													
-	frameBox->SetMass(bodyMass);
-	frameBox->SetPos(bodyPos);
-	mphysicalSystem.Add(frameBox);
-	
-
-	//add legs
-	double legLength = sqrt(wheelPos[0].x()*wheelPos[0].x() + wheelPos[0].y()*wheelPos[0].y());
-
-	auto legColor = std::make_shared<ChColorAsset>();
-	legColor->SetColor(ChColor(0.2f, 0.25f, 0.25f));
-	floorBody->AddAsset(legColor);
-
-	auto leg0 = std::make_shared<ChBodyEasyBox>(legLength, legVis, legVis, 1000, false, true);
-	leg0->SetMass(legMass);
-	leg0->SetPos(ChVector<>((wheelPos[0].x()+bodyPos.x()) / 2.0, (wheelPos[0].y() + bodyPos.y()) / 2.0,wheelPos[0].z()));
-	leg0->SetRot(Q_from_AngZ(-atan2(wheelPos[0].y() + bodyPos.y(), wheelPos[0].x() + bodyPos.x())));
-	mphysicalSystem.Add(leg0);
-	leg0->AddAsset(legColor);
-
-	auto leg0Joint = std::make_shared<ChLinkLockRevolute>();
-	leg0Joint->Initialize(frameBox, leg0, ChCoordsys<>(ChVector<>(bodyPos.x(),bodyPos.y(),wheelPos[0].z()), Q_from_AngY(0)));
-	mphysicalSystem.Add(leg0Joint);
-
-	auto leg1 = std::make_shared<ChBodyEasyBox>(legLength, legVis, legVis, 1000, false, true);
-	leg1->SetMass(legMass);
-	leg1->SetPos(ChVector<>((wheelPos[1].x() + bodyPos.x()) / 2.0, (wheelPos[1].y() + bodyPos.y()) / 2.0, wheelPos[1].z()));
-	leg1->SetRot(Q_from_AngZ(-atan2(wheelPos[1].y() + bodyPos.y(), wheelPos[1].x() + bodyPos.x())));
-	mphysicalSystem.Add(leg1);
-	leg1->AddAsset(legColor);
-
-	auto leg1Joint = std::make_shared<ChLinkLockRevolute>();
-	leg1Joint->Initialize(frameBox, leg1, ChCoordsys<>(ChVector<>(bodyPos.x(), bodyPos.y(), wheelPos[1].z()), Q_from_AngY(0)));
-	mphysicalSystem.Add(leg1Joint);
-
-	auto leg2 = std::make_shared<ChBodyEasyBox>(legLength, legVis, legVis, 1000, false, true);
-	leg2->SetMass(legMass);
-	leg2->SetPos(ChVector<>((wheelPos[2].x() + bodyPos.x()) / 2.0, (wheelPos[2].y() + bodyPos.y()) / 2.0, wheelPos[2].z()));
-	leg2->SetRot(Q_from_AngZ(-atan2(wheelPos[2].y() + bodyPos.y(), wheelPos[2].x() + bodyPos.x())));
-	mphysicalSystem.Add(leg2);
-	leg0->AddAsset(legColor);
-
-	auto leg2Joint = std::make_shared<ChLinkLockRevolute>();
-	leg2Joint->Initialize(frameBox, leg2, ChCoordsys<>(ChVector<>(bodyPos.x(), bodyPos.y(), wheelPos[2].z()), Q_from_AngY(0)));
-	mphysicalSystem.Add(leg2Joint);
-
-	auto leg3 = std::make_shared<ChBodyEasyBox>(legLength, legVis, legVis, 1000, false, true);
-	leg3->SetMass(legMass);
-	leg3->SetPos(ChVector<>((wheelPos[3].x() + bodyPos.x()) / 2.0, (wheelPos[3].y() + bodyPos.y()) / 2.0, wheelPos[3].z()));
-	leg3->SetRot(Q_from_AngZ(-atan2(wheelPos[3].y()+bodyPos.y(), wheelPos[3].x()+bodyPos.x())));
-	mphysicalSystem.Add(leg3);
-	leg0->AddAsset(legColor);
-
-	auto leg3Joint = std::make_shared<ChLinkLockRevolute>();
-	leg3Joint->Initialize(frameBox, leg3, ChCoordsys<>(ChVector<>(bodyPos.x(), bodyPos.y(), wheelPos[3].z()), Q_from_AngY(0)));
-	mphysicalSystem.Add(leg3Joint);
-
-
-
-
-
-
-
-	//add wheels
-	auto wheel_texture = std::make_shared<ChTexture>();
-	wheel_texture->SetTextureFilename(GetChronoDataFile("redwhite.png"));  // texture in ../data
-	
-
-	auto wheel_0 = std::make_shared<ChBodyEasyCylinder>(wheelRadius, wheelWidth, 1000, true, true);
-	wheel_0->SetPos(wheelPos[0]);
-	wheel_0->SetRot(Q_from_AngX(CH_C_PI / 2.0));
-	wheel_0->SetMass(wheelMass);
-	mphysicalSystem.Add(wheel_0);
-	wheel_0->AddAsset(wheel_texture);
-
-	//create a revolute joint for wheel 1 and chassis
-	auto wheel0joint = std::make_shared<ChLinkLockRevolute>();
-	wheel0joint->Initialize(leg0, wheel_0, ChCoordsys<>(wheelPos[0],Q_from_AngY(0)));
-	mphysicalSystem.Add(wheel0joint);
-
-
-	auto wheel_1 = std::make_shared<ChBodyEasyCylinder>(wheelRadius, wheelWidth, 1000, true, true);
-	wheel_1->SetPos(wheelPos[1]);
-	wheel_1->SetRot(Q_from_AngX(CH_C_PI / 2.0));
-	wheel_1->SetMass(wheelMass);
-	mphysicalSystem.Add(wheel_1);
-	wheel_1->AddAsset(wheel_texture);
-
-	//create a revolute joint for wheel 1 and chassis
-	auto wheel1joint = std::make_shared<ChLinkLockRevolute>();
-	wheel1joint->Initialize(leg1, wheel_1, ChCoordsys<>(wheelPos[1], Q_from_AngY(0)));
-	mphysicalSystem.Add(wheel1joint);
-
-	auto wheel_2 = std::make_shared<ChBodyEasyCylinder>(wheelRadius, wheelWidth, 1000, true, true);
-	wheel_2->SetPos(wheelPos[2]);
-	wheel_2->SetRot(Q_from_AngX(CH_C_PI / 2.0));
-	wheel_2->SetMass(wheelMass);
-	mphysicalSystem.Add(wheel_2);
-	wheel_2->AddAsset(wheel_texture);
-
-	//create a revolute joint for wheel 1 and chassis
-	auto wheel2joint = std::make_shared<ChLinkLockRevolute>();
-	wheel2joint->Initialize(leg2, wheel_2, ChCoordsys<>(wheelPos[2], Q_from_AngY(0)));
-	mphysicalSystem.Add(wheel2joint);
-
-	auto wheel_3 = std::make_shared<ChBodyEasyCylinder>(wheelRadius, wheelWidth, 1000, true, true);
-	wheel_3->SetPos(wheelPos[3]);
-	wheel_3->SetRot(Q_from_AngX(CH_C_PI / 2.0));
-	wheel_3->SetMass(wheelMass);
-	mphysicalSystem.Add(wheel_3);
-	wheel_3->AddAsset(wheel_texture);
-
-	//create a revolute joint for wheel 1 and chassis
-	auto wheel3joint = std::make_shared<ChLinkLockRevolute>();
-	wheel3joint->Initialize(leg3, wheel_3, ChCoordsys<>(wheelPos[3], Q_from_AngY(0)));
-	mphysicalSystem.Add(wheel3joint);
-
-
-
-	//add springs
-	auto springtLeft = std::make_shared<ChLinkSpring>();
-	springtLeft->Initialize(leg0,	// first body to link it with
-		leg1,	// second body to link it with
-		false,	// pos absolute
-		springStartLeft, // position of first end of spring
-		springEndLeft, // position of second end of spring
-		false,	// rest length not original length
-		restLength);	// rest length
-	mphysicalSystem.Add(springtLeft);
-	springtLeft->Set_SpringK(k);
-	springtLeft->Set_SpringR(c);
-	// Attach a visualization asset.
-	springtLeft->AddAsset(color);
-	springtLeft->AddAsset(std::make_shared<ChPointPointSpring>(.0125, 20, 10));
-
-	auto springtRight = std::make_shared<ChLinkSpring>();
-	springtRight->Initialize(leg2,	// first body to link it with
-		leg3,	// second body to link it with
-		false,	// pos absolute
-		springStartRight, // position of first end of spring
-		springEndRight, // position of second end of spring
-		false,	// rest length not original length
-		restLength);	// rest length
-	mphysicalSystem.Add(springtRight);
-	springtRight->Set_SpringK(k);
-	springtRight->Set_SpringR(c);
-	// Attach a visualization asset.
-	springtRight->AddAsset(color);
-	springtRight->AddAsset(std::make_shared<ChPointPointSpring>(.0125, 20, 10));
-
-
-	//Add differential bar (assumed to be on top of chassis frame
-
-
-
-
-
-
-
-
-
-
+	RoverModel rover = BuildRoverC(mphysicalSystem, roverParams);
 
 
 	//Add obstacles
-	auto obstacleTexture = std::make_shared<ChTexture>();
-	obstacleTexture->SetTextureFilename(GetChronoDataFile("cubetexture_wood.png"));  // texture in ../data
-
-	auto obstacleBox1 = std::make_shared<ChBodyEasyBox>(.2, .1, 1.22, 1000, true, true);
-	obstacleBox1->SetPos(ChVector<>(2.0, -.5, 0));
-	mphysicalSystem.Add(obstacleBox1);
-	obstacleBox1->SetBodyFixed(true);
-	obstacleBox1->AddAsset(obstacleTexture);
-
-	auto obsCyl = std::make_shared<ChBodyEasyCylinder>(12 * in2m, 3, 1000, true, true);
-	obsCyl->SetPos(ChVector<>(3.0, -.5, 0));
-	obsCyl->SetBodyFixed(true);
-	obsCyl->SetRot(Q_from_AngX(CH_C_PI / 2.0));
-	obsCyl->AddAsset(obstacleTexture);
-	mphysicalSystem.Add(obsCyl);
-
-
-	
-
-
-	//set torque on the wheels
-	wheel0joint->Set_Scr_torque(torqueLeftSide);
-	wheel1joint->Set_Scr_torque(torqueLeftSide);
-	wheel2joint->Set_Scr_torque(torqueRightSide);
-	wheel3joint->Set_Scr_torque(torqueRightSide);
-	
-
-
-	
+	auto obstacleBox1 = AddObstacleBox(mphysicalSystem, ChVector<>(.2, .1, 1.22), ChVector<>(2.0, -.5, 0));
+	auto obsCyl = AddObstacleCylinder(mphysicalSystem, 12 * in2m, 3, ChVector<>(3.0, -.5, 0));
 
 
     //======================================================================
 
+	// Draw at a fixed sim-time interval instead of once per physics step. Set up before AssetBindAll,
+	// which binds the display proxies with --threaded.
+	RenderControl renderControl(&mphysicalSystem, &displaySystem);
+	renderControl.ParseArgs(argc, argv);
+	application.SetUserEventReceiver(&renderControl);
+
     // Use this function for adding a ChIrrNodeAsset to all items
     // Otherwise use application.AssetBind(myitem); on a per-item basis.
     application.AssetBindAll();
@@ -326,21 +112,65 @@ int main(int argc, char* argv[]) {
     application.SetTryRealtime(false);
 	mphysicalSystem.SetMaxItersSolverSpeed(5000);
 
+	//--solver-tol <tol> -> stop the speed solver on a residual tolerance, 5000 iterations stay the cap
+	double solverTolerance = 0;
+	for (int i = 1; i + 1 < argc; i++)
+		if (strcmp(argv[i], "--solver-tol") == 0)
+			solverTolerance = atof(argv[i + 1]);
+	SolverStats solverStats(mphysicalSystem, solverTolerance);
+
+	// Suspension spring statistics, printed at exit -> full per-step CSV with --spring-telemetry <file>
+	const char* springTelemetryFile = nullptr;
+	for (int a = 1; a + 1 < argc; a++)
+		if (strcmp(argv[a], "--spring-telemetry") == 0)
+			springTelemetryFile = argv[a + 1];
+	SpringTelemetrySettings springSettings;
+	springSettings.keepHistory = springTelemetryFile != nullptr;
+	SpringTelemetry springTelemetry(rover.springs, springSettings);
+
+	// --drive <file> -> replay a recorded drive log instead of the constant torques (see drive_commands.h)
+	DriveCommandStream driveCommands;
+	const char* driveLogFile = nullptr;
+	for (int a = 1; a + 1 < argc; a++)
+		if (strcmp(argv[a], "--drive") == 0)
+			driveLogFile = argv[a + 1];
+	if (driveLogFile) {
+		if (!driveCommands.Open(driveLogFile) || !driveCommands.Fits(rover)) {
+			std::cerr << "Cannot drive this rover from " << driveLogFile << std::endl;
+			return 1;
+		}
+		driveCommands.Apply(rover, mphysicalSystem.GetChTime());
+	}
+
     //
     // THE SOFT-REAL-TIME CYCLE
     //
-	int i = 0;
     while (application.GetDevice()->run()) {
-        application.BeginScene();
-
-        application.DrawAll();
-
-        // This performs the integration timestep!
+        // This performs the integration timesteps up to the next frame!
         //application.DoStep();
-		mphysicalSystem.DoStepDynamics(step_size);
+		if (!renderControl.Advance(step_size, [&]() {
+			solverStats.Record();
+			springTelemetry.Record(mphysicalSystem.GetChTime());
+			if (driveLogFile)
+				driveCommands.Apply(rover, mphysicalSystem.GetChTime());
+		}))
+			continue;
 
+        application.BeginScene();
+        application.DrawAll();
         application.EndScene();
     }
+	renderControl.Stop();
+
+	solverStats.PrintSummary(std::cout);
+	renderControl.PrintSummary(std::cout);
+	if (driveLogFile)
+		driveCommands.PrintSummary(std::cout);
+	springTelemetry.PrintSummary(std::cout);
+	if (springTelemetryFile) {
+		std::ofstream springCsv(springTelemetryFile);
+		springTelemetry.WriteCsv(springCsv);
+	}
 
     return 0;
 }
@@ -18,16 +18,44 @@
 #include "chrono/physics/ChLinkMate.h"
 #include "chrono/assets/ChTexture.h"
 #include "chrono/assets/ChColorAsset.h"
-#include "chrono_irrlicht/ChIrrApp.h"
 #include "chrono/assets/ChPointPointDrawing.h"
 
+#include "rover_model.h"
+#include "trajectory.h"
+#include "adaptive_step.h"
+#include "solver_stats.h"
+#include "collision_stats.h"
+#include "checkpoint.h"
+#include "pose_cache.h"
+#include "realtime_pacer.h"
+#include "drive_commands.h"
+#include "rover_controller.h"
+#include "shm_bridge.h"
+#include "wheel_contacts.h"
+#include "spring_telemetry.h"
+
+#ifndef ROVER_HEADLESS
+#include "chrono_irrlicht/ChIrrApp.h"
+
+#include "render_control.h"
+#include "frame_capture.h"
+#endif
+
 #include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
 
 
 
 // Use the namespace of Chrono
 
 using namespace chrono;
+
+#ifndef ROVER_HEADLESS
 using namespace chrono::irrlicht;
 
 // Use the main namespaces of Irrlicht
@@ -38,54 +66,60 @@ using namespace irr::scene;
 using namespace irr::video;
 using namespace irr::io;
 using namespace irr::gui;
-
-//I will clean this up and move the robot into its own class later. For now I don't want to waste that time
-
-//Robot parameters -> robot is oriented with X forward, Y up, and Z right. Origin is at center of left front wheel
-//double robotLength = .6096*2;	//length from center front wheel to center rear wheel -> this is a function of other robot parameters
-double robotWidth = .9144;		//width from center wheel to center wheel 
-
-double wheelWidth = .15;
-double wheelDia = .2286;
-double wheelMass = 3;
-
-double chassisW = .6096;
-double chassisL = .6096;
-double chassisH = .15;
-double chassisMass = 30;
-
-//connection points -> all angles are just angles at design configuration. The ride angles will change based on many robot parameters
-
-//tibia is connector to front and rear wheels (larger bone in shin as it supports more direct weight ;) )
-double tibiaLength = .3512;
-double tibiaAngle = 30 * CH_C_PI / 180.0;	//degrees to radians and from horizontal
-double tibiaMass = .25;
-
-//thigh is connector from knee to chassis
-double conW = 0.025;		//width of the square tube for thighs and shins -> no need to change this
-
-double thighLength;
-//double thighLength = .3244;	//Thigh length is a result of angles and shin lengths
-double thighAngle = 30 * CH_C_PI / 180.0;	//degrees to radians and from horizontal
-double thighMass = .25;
-
-//tibia is connector to front and rear wheels (larger bone in shin as it supports more direct weight ;) )
-double fibulaLength = .3512;
-double fibulaAngle = 30 * CH_C_PI / 180.0;	//degrees to radians and from horizontal
-double fibulaMass = .25;
-
-
-
-//Spring properties
-double tibiaSpringPt = 0.15; //distance from knee to spring connection point on fibula
-double fibulaSpringPt = 0.15; //distance from knee to spring connection point on tibia
-double k = 10000;			//spring constant between tibia and fibula
-double c = 1000;			//damping coefficient between tibia and fibula
-double restLength = .22;		//rest length of springs
-
-//Torque values at wheels
-double torqueLeftSide = 2;
-double torqueRightSide = 2;
+#endif
+
+//Robot parameters -> the design lives in RoverDParameters (rover_model.h). Change a field here
+//or edit the defaults there. Robot is oriented with X forward, Y up, and Z right.
+RoverDParameters roverParams;
+
+//Headless run settings -> only used by the roverD_headless target (built with ROVER_HEADLESS)
+//usage: roverD_headless [duration in seconds] [step size in seconds] [--trajectory file]
+//                       [--adaptive min max] [--step-history file] [--solver-tol tol]
+//                       [--load-checkpoint file] [--save-checkpoint file] [--pose-cache dir]
+//                       [--self-collision] [--realtime factor] [--pace-batch n] [--drive file]
+//                       [--control hz] [--control-speed w] [--control-turn w] [--control-slip w]
+//                       [--bridge name] [--bridge-lockstep] [--bridge-ring n] [--bridge-timeout s]
+//                       [--wheel-contacts file] [--spring-telemetry file]
+//Duration counts from the loaded checkpoint time. The checkpoint is saved at the end of the run.
+double headlessDuration = 10.0;
+const char* trajectoryFile = nullptr;  //binary trajectory of every body (see trajectory.h)
+bool adaptiveStep = false;             //vary the step between min and max (see adaptive_step.h)
+AdaptiveStepSettings adaptiveSettings;
+const char* stepHistoryFile = nullptr; //CSV of every adaptive step
+const char* loadCheckpointFile = nullptr;  //full system state, see checkpoint.h
+const char* saveCheckpointFile = nullptr;
+const char* poseCacheDir = nullptr;     //start from the cached settled pose (see pose_cache.h)
+const char* wheelContactsFile = nullptr;  //CSV of every wheel's load, traction and slip per step (see wheel_contacts.h)
+const char* springTelemetryFile = nullptr; //CSV of every spring's length, deflection, force and damper energy per step
+
+//--solver-tol <tol> -> the speed solver stops once its residual is below tol instead of always
+//running the full SetMaxItersSolverSpeed iterations. Iterations and residuals are reported at exit.
+double solverTolerance = 0;
+
+//--self-collision -> build the rover without collision families (see RoverCollisionFamily), to compare
+//the broadphase pair and contact counts reported at exit
+bool selfCollision = false;
+
+//--realtime <factor> -> lock sim time to wall time (see realtime_pacer.h) and report deadline misses at exit,
+//releasing --pace-batch steps at a time. Used to check whether a CPU holds the 1 kHz step in real time.
+bool realtime = false;
+PacerSettings pacerSettings;
+
+//--drive <file> -> replay a recorded drive log (CSV or binary, see drive_commands.h) instead of the constant
+//torqueLeftSide/torqueRightSide. Log times are sim time. Works with and without the window.
+const char* driveLogFile = nullptr;
+
+//--control <hz> -> close the loop with the skid-steer controller at hz instead (see rover_controller.h), tracking
+//--control-speed and --control-turn wheel speeds in rad/s. --control-slip > 0 adds traction control.
+double controlRate = 0;
+SkidSteerController skidSteer;
+double controlSlip = 0;
+
+//--bridge <name> -> take the wheel torques from an external process through the shared memory region name and
+//publish the rover state to it after every step (see shm_bridge.h, rover_bridge_client.cpp). --bridge-lockstep
+//waits for the answer to every state, up to --bridge-timeout seconds.
+const char* bridgeName = nullptr;
+ShmBridgeSettings bridgeSettings;
 
 
 int main(int argc, char* argv[]) {
@@ -95,9 +129,14 @@ int main(int argc, char* argv[]) {
     // Create a Chrono physical system
     ChSystemNSC mphysicalSystem;
 
+#ifndef ROVER_HEADLESS
+    // With --threaded, Irrlicht draws proxies in a display system while physics steps on its own thread
+    ChSystemNSC displaySystem;
+
     // Create the Irrlicht visualization (open the Irrlicht device,
     // bind a simple user interface, etc. etc.)
-    ChIrrApp application(&mphysicalSystem, L"A simple project template", core::dimension2d<u32>(1280,920),
+    ChIrrApp application(RenderControl::IsThreaded(argc, argv) ? &displaySystem : &mphysicalSystem,
+                         L"A simple project template", core::dimension2d<u32>(1280,920),
                          false);  // screen dimensions
 
     // Easy shortcuts to add camera, lights, logo and sky in Irrlicht scene:
@@ -106,531 +145,284 @@ int main(int argc, char* argv[]) {
     application.AddTypicalCamera(core::vector3df(4, 1, -5),
                                  core::vector3df(0, .5, 0));  // to change the position of camera
     // application.AddLightWithShadow(vector3df(1,25,-5), vector3df(0,0,0), 35, 0.2,35, 55, 512, video::SColorf(1,1,1));
+#endif
 
     //======================================================================
 
-    // HERE YOU CAN POPULATE THE PHYSICAL SYSTEM WITH BODIES AND LINKS.
-    //
-    // An example: a pendulum.
-
-    // 1-Create a floor that is fixed (that is used also to represent the absolute reference)
-	
-	// Create a material that will be used for the floor
-	//auto mmaterial = std::make_shared<ChMaterialSurfaceNSC>();
-	//mmaterial->SetFriction(0.4f);
-	//mmaterial->SetCompliance(0.0000005f);
-	//mmaterial->SetComplianceT(0.0000005f);
-	//mmaterial->SetDampingF(0.2f);
-
-    auto floorBody = std::make_shared<ChBodyEasyBox>(100, 2, 100,  // x, y, z dimensions
-                                                     1000,       // density
-                                                     true,      // contact geometry - allow collision
-                                                     true        // enable visualization geometry
-                                                     );
-    floorBody->SetPos(ChVector<>(0, -1.3, 0));
-	//floorBody->SetMaterialSurface(mmaterial);
-    floorBody->SetBodyFixed(true);
-
-    mphysicalSystem.Add(floorBody);
-	// Optionally, attach a RGB color asset to the floor, for better visualization
-	auto color = std::make_shared<ChColorAsset>();
-	color->SetColor(ChColor(0.2f, 0.25f, 0.25f));
-	floorBody->AddAsset(color);
+#ifdef ROVER_HEADLESS
+	//no Irrlicht device -> skip textures and visualization shapes
+	roverParams.visualization = false;
+#endif
 
+	for (int i = 1; i < argc; i++)
+		if (strcmp(argv[i], "--self-collision") == 0)
+			selfCollision = true;
+	roverParams.filterSelfCollision = !selfCollision;
 
+    // 1-Create a floor that is fixed (that is used also to represent the absolute reference)
+	auto floorBody = AddFloor(mphysicalSystem, -.3, 100, 2, roverParams.visualization);
 
 	//-----------------------ROBOT----------------------------------//
+	RoverModel rover = BuildRoverD(mphysicalSystem, roverParams);
+	auto chassis = rover.chassis;
 
-	//figure out thigh length
-	thighLength = ( tibiaLength*cos(tibiaAngle) ) / cos(thighAngle);
-	double robotLength = 2.0*tibiaLength*cos(tibiaAngle) + 2.0*fibulaLength*cos(fibulaAngle);
-
-
-	// Add chassis
-	auto chassis = std::make_shared<ChBodyEasyBox>(chassisL, chassisH, chassisW,	// x,y,z size
-		200,													// density
-		true,													// collide enable?
-		true													// visualization?		
-		);													
-	chassis->SetMass(chassisMass);
-	chassis->SetPos(ChVector<>(-(tibiaLength*cos(tibiaAngle) + thighLength*cos(thighAngle)), //X location
-		tibiaLength*sin(tibiaAngle) + thighLength*sin(thighAngle),  //Y location
-		robotWidth/2.0));
-	mphysicalSystem.Add(chassis);
-	chassis->SetBodyFixed(false);
-	
-	//create the attachments to the body
-
-	//left front thigh
-	auto thighLF = std::make_shared<ChBodyEasyBox>(thighLength, conW, conW,	// x,y,z size
-		200,													// density
-		false,													// collide enable?
-		true													// visualization?		
-		);
-	thighLF->SetMass(thighMass);
-	thighLF->SetPos(ChVector<>(-(tibiaLength*cos(tibiaAngle) + .5*thighLength*cos(thighAngle)),		//X direction
-		tibiaLength*sin(tibiaAngle)+.5*thighLength*sin(thighAngle),
-		wheelWidth/2.0+conW));
-	thighLF->SetRot(Q_from_AngZ(-thighAngle));
-	mphysicalSystem.Add(thighLF);
-
-	//left rear thigh
-	auto thighLR = std::make_shared<ChBodyEasyBox>(thighLength, conW, conW,	// x,y,z size
-		200,													// density
-		false,													// collide enable?
-		true													// visualization?		
-		);
-	thighLR->SetMass(thighMass);
-	thighLR->SetPos(ChVector<>(-(tibiaLength*cos(tibiaAngle) + 1.5*thighLength*cos(thighAngle)),		//X direction
-		tibiaLength*sin(tibiaAngle) + .5*thighLength*sin(thighAngle),
-		wheelWidth / 2.0 + conW));
-	thighLR->SetRot(Q_from_AngZ(thighAngle));
-	mphysicalSystem.Add(thighLR);
-
-	//right front thigh
-	auto thighRF = std::make_shared<ChBodyEasyBox>(thighLength, conW, conW,	// x,y,z size
-		200,													// density
-		false,													// collide enable?
-		true													// visualization?		
-		);
-	thighRF->SetMass(thighMass);
-	thighRF->SetPos(ChVector<>(-(tibiaLength*cos(tibiaAngle) + .5*thighLength*cos(thighAngle)),		//X direction
-		tibiaLength*sin(tibiaAngle) + .5*thighLength*sin(thighAngle),
-		robotWidth - (wheelWidth / 2.0 + conW)));
-	thighRF->SetRot(Q_from_AngZ(-thighAngle));
-	mphysicalSystem.Add(thighRF);
-
-	//right front thigh
-	auto thighRR = std::make_shared<ChBodyEasyBox>(thighLength, conW, conW,	// x,y,z size
-		200,													// density
-		false,													// collide enable?
-		true													// visualization?		
-		);
-	thighRR->SetMass(thighMass);
-	thighRR->SetPos(ChVector<>(-(tibiaLength*cos(tibiaAngle) + 1.5*thighLength*cos(thighAngle)),		//X direction
-		tibiaLength*sin(tibiaAngle) + .5*thighLength*sin(thighAngle),
-		robotWidth - (wheelWidth / 2.0 + conW)));
-	thighRR->SetRot(Q_from_AngZ(thighAngle));
-	mphysicalSystem.Add(thighRR);
-
-	//connect the thighs to the chassis
-	auto thighLFJoint = std::make_shared<ChLinkLockRevolute>();
-	thighLFJoint->Initialize(chassis, thighLF, ChCoordsys<>(ChVector<>(-(tibiaLength*cos(tibiaAngle) + thighLength*cos(thighAngle)), //X location
-		tibiaLength*sin(tibiaAngle) + thighLength*sin(thighAngle),  //Y location
-		thighLF->GetPos().z()),	//Z location
-		{ 1,0,0,0 }));	//rotation
-	mphysicalSystem.Add(thighLFJoint);
-
-	auto thighLRJoint = std::make_shared<ChLinkLockRevolute>();
-	thighLRJoint->Initialize(chassis, thighLR, ChCoordsys<>(ChVector<>(-(tibiaLength*cos(tibiaAngle) + thighLength*cos(thighAngle)), //X location
-		tibiaLength*sin(tibiaAngle) + thighLength*sin(thighAngle),  //Y location
-		thighLR->GetPos().z()),	//Z location
-		{ 1,0,0,0 }));	//rotation
-	mphysicalSystem.Add(thighLRJoint);
-
-	auto thighRFJoint = std::make_shared<ChLinkLockRevolute>();
-	thighRFJoint->Initialize(chassis, thighRF, ChCoordsys<>(ChVector<>(-(tibiaLength*cos(tibiaAngle) + thighLength*cos(thighAngle)), //X location
-		tibiaLength*sin(tibiaAngle) + thighLength*sin(thighAngle),  //Y location
-		thighRF->GetPos().z()),	//Z location
-		{ 1,0,0,0 }));	//rotation
-	mphysicalSystem.Add(thighRFJoint);
-
-	auto thighRRJoint = std::make_shared<ChLinkLockRevolute>();
-	thighRRJoint->Initialize(chassis, thighRR, ChCoordsys<>(ChVector<>(-(tibiaLength*cos(tibiaAngle) + thighLength*cos(thighAngle)), //X location
-		tibiaLength*sin(tibiaAngle) + thighLength*sin(thighAngle),  //Y location
-		thighRR->GetPos().z()),	//Z location
-		{ 1,0,0,0 }));	//rotation
-	mphysicalSystem.Add(thighRRJoint);
-
-
-
-
-	//Add shins
-
-	//left front tibia
-	auto tibiaLF = std::make_shared<ChBodyEasyBox>(tibiaLength, conW, conW,	// x,y,z size
-		200,													// density
-		false,													// collide enable?
-		true													// visualization?		
-		);
-	tibiaLF->SetMass(tibiaMass);
-	tibiaLF->SetPos(ChVector<>(-.5*tibiaLength*cos(tibiaAngle),		//X direction
-		.5*tibiaLength*sin(tibiaAngle),
-		wheelWidth / 2.0 + conW));
-	tibiaLF->SetRot(Q_from_AngZ(-tibiaAngle));
-	mphysicalSystem.Add(tibiaLF);
-
-	//left rear tibia
-	auto tibiaLR = std::make_shared<ChBodyEasyBox>(tibiaLength, conW, conW,	// x,y,z size
-		200,													// density
-		false,													// collide enable?
-		true													// visualization?		
-		);
-	tibiaLR->SetMass(tibiaMass);
-	tibiaLR->SetPos(ChVector<>(-(1.5*tibiaLength*cos(tibiaAngle) + 2 * thighLength*cos(thighAngle)),		//X direction
-		.5*tibiaLength*sin(tibiaAngle),
-		wheelWidth / 2.0 + conW));
-	tibiaLR->SetRot(Q_from_AngZ(tibiaAngle));
-	mphysicalSystem.Add(tibiaLR);
-
-	//right front tibia
-	auto tibiaRF = std::make_shared<ChBodyEasyBox>(tibiaLength, conW, conW,	// x,y,z size
-		200,													// density
-		false,													// collide enable?
-		true													// visualization?		
-		);
-	tibiaRF->SetMass(tibiaMass);
-	tibiaRF->SetPos(ChVector<>(-.5*tibiaLength*cos(tibiaAngle),		//X direction
-		.5*tibiaLength*sin(tibiaAngle),
-		robotWidth - (wheelWidth / 2.0 + conW)));
-	tibiaRF->SetRot(Q_from_AngZ(-tibiaAngle));
-	mphysicalSystem.Add(tibiaRF);
-
-	//right rear tibia
-	auto tibiaRR = std::make_shared<ChBodyEasyBox>(tibiaLength, conW, conW,	// x,y,z size
-		200,													// density
-		false,													// collide enable?
-		true													// visualization?		
-		);
-	tibiaRR->SetMass(tibiaMass);
-	tibiaRR->SetPos(ChVector<>(-(1.5*tibiaLength*cos(tibiaAngle) + 2 * thighLength*cos(thighAngle)),		//X direction
-		.5*tibiaLength*sin(tibiaAngle),
-		robotWidth - (wheelWidth / 2.0 + conW)));
-	tibiaRR->SetRot(Q_from_AngZ(tibiaAngle));
-	mphysicalSystem.Add(tibiaRR);
-
-	//connect the thighs to the tibias
-	auto tibiaLFJoint = std::make_shared<ChLinkLockRevolute>();
-	tibiaLFJoint->Initialize(thighLF, tibiaLF, ChCoordsys<>(ChVector<>(-(tibiaLength*cos(tibiaAngle)), //X location
-		tibiaLength*sin(tibiaAngle),  //Y location
-		tibiaLF->GetPos().z()),	//Z location
-		{ 1,0,0,0 }));	//rotation
-	mphysicalSystem.Add(tibiaLFJoint);
-
-	auto tibiaLRJoint = std::make_shared<ChLinkLockRevolute>();
-	tibiaLRJoint->Initialize(thighLR, tibiaLR, ChCoordsys<>(ChVector<>(-(2.0*thighLength*cos(thighAngle)+tibiaLength*cos(tibiaAngle)), //X location
-		tibiaLength*sin(tibiaAngle),  //Y location
-		tibiaLR->GetPos().z()),	//Z location
-		{ 1,0,0,0 }));	//rotation
-	mphysicalSystem.Add(tibiaLRJoint);
-
-	auto tibiaRFJoint = std::make_shared<ChLinkLockRevolute>();
-	tibiaRFJoint->Initialize(thighRF, tibiaRF, ChCoordsys<>(ChVector<>(-(tibiaLength*cos(tibiaAngle)), //X location
-		tibiaLength*sin(tibiaAngle),  //Y location
-		tibiaRF->GetPos().z()),	//Z location
-		{ 1,0,0,0 }));	//rotation
-	mphysicalSystem.Add(tibiaRFJoint);
-
-	auto tibiaRRJoint = std::make_shared<ChLinkLockRevolute>();
-	tibiaRRJoint->Initialize(thighRR, tibiaRR, ChCoordsys<>(ChVector<>(-(2.0*thighLength*cos(thighAngle) + tibiaLength*cos(tibiaAngle)), //X location
-		tibiaLength*sin(tibiaAngle),  //Y location
-		tibiaRR->GetPos().z()),	//Z location
-		{ 1,0,0,0 }));	//rotation
-	mphysicalSystem.Add(tibiaRRJoint);
-
-
-	//left front fibula
-	auto fibulaLF = std::make_shared<ChBodyEasyBox>(fibulaLength, conW, conW,	// x,y,z size
-		200,													// density
-		false,													// collide enable?
-		true													// visualization?		
-		);
-	fibulaLF->SetMass(fibulaMass);
-	fibulaLF->SetPos(ChVector<>(-(tibiaLength*cos(tibiaAngle) + .5*fibulaLength*cos(fibulaAngle)),		//X direction
-		.5*fibulaLength*sin(fibulaAngle),
-		wheelWidth / 2.0 + conW));
-	fibulaLF->SetRot(Q_from_AngZ(fibulaAngle));
-	mphysicalSystem.Add(fibulaLF);
-
-	//left front fibula
-	auto fibulaLR = std::make_shared<ChBodyEasyBox>(fibulaLength, conW, conW,	// x,y,z size
-		200,													// density
-		false,													// collide enable?
-		true													// visualization?		
-		);
-	fibulaLR->SetMass(fibulaMass);
-	fibulaLR->SetPos(ChVector<>(-(tibiaLength*cos(tibiaAngle) + 1.5*fibulaLength*cos(fibulaAngle)),		//X direction
-		.5*fibulaLength*sin(fibulaAngle),
-		wheelWidth / 2.0 + conW));
-	fibulaLR->SetRot(Q_from_AngZ(-fibulaAngle));
-	mphysicalSystem.Add(fibulaLR);
-
-	//left front fibula
-	auto fibulaRF = std::make_shared<ChBodyEasyBox>(fibulaLength, conW, conW,	// x,y,z size
-		200,													// density
-		false,													// collide enable?
-		true													// visualization?		
-		);
-	fibulaRF->SetMass(fibulaMass);
-	fibulaRF->SetPos(ChVector<>(-(tibiaLength*cos(tibiaAngle) + .5*fibulaLength*cos(fibulaAngle)),		//X direction
-		.5*fibulaLength*sin(fibulaAngle),
-		robotWidth - (wheelWidth / 2.0 + conW)));
-	fibulaRF->SetRot(Q_from_AngZ(fibulaAngle));
-	mphysicalSystem.Add(fibulaRF);
-
-	//right rear fibula
-	auto fibulaRR = std::make_shared<ChBodyEasyBox>(fibulaLength, conW, conW,	// x,y,z size
-		200,													// density
-		false,													// collide enable?
-		true													// visualization?		
-		);
-	fibulaRR->SetMass(fibulaMass);
-	fibulaRR->SetPos(ChVector<>(-(tibiaLength*cos(tibiaAngle) + 1.5*fibulaLength*cos(fibulaAngle)),		//X direction
-		.5*fibulaLength*sin(fibulaAngle),
-		robotWidth - (wheelWidth / 2.0 + conW)));
-	fibulaRR->SetRot(Q_from_AngZ(-fibulaAngle));
-	mphysicalSystem.Add(fibulaRR);
-
-	//connect fibulas to thighs and each other
-	auto fibulaLFJoint = std::make_shared<ChLinkLockRevolute>();
-	fibulaLFJoint->Initialize(thighLF, fibulaLF, ChCoordsys<>(ChVector<>(-tibiaLength*cos(tibiaAngle), //X location
-		tibiaLength*sin(tibiaAngle),  //Y location
-		fibulaLF->GetPos().z()),	//Z location
-		{ 1,0,0,0 }));	//rotation
-	mphysicalSystem.Add(fibulaLFJoint);
-
-	auto fibulaLRJoint = std::make_shared<ChLinkLockRevolute>();
-	fibulaLRJoint->Initialize(thighLR, fibulaLR, ChCoordsys<>(ChVector<>(-(2.0*thighLength*cos(thighAngle) + tibiaLength*cos(tibiaAngle)), //X location
-		tibiaLength*sin(tibiaAngle),  //Y location
-		fibulaLR->GetPos().z()),	//Z location
-		{ 1,0,0,0 }));	//rotation
-	mphysicalSystem.Add(fibulaLRJoint);
-
-	auto fibulaRFJoint = std::make_shared<ChLinkLockRevolute>();
-	fibulaRFJoint->Initialize(thighRF, fibulaRF, ChCoordsys<>(ChVector<>(-tibiaLength*cos(tibiaAngle), //X location
-		tibiaLength*sin(tibiaAngle),  //Y location
-		fibulaRF->GetPos().z()),	//Z location
-		{ 1,0,0,0 }));	//rotation
-	mphysicalSystem.Add(fibulaRFJoint);
-
-	auto fibulaRRJoint = std::make_shared<ChLinkLockRevolute>();
-	fibulaRRJoint->Initialize(thighRR, fibulaRR, ChCoordsys<>(ChVector<>(-(2.0*thighLength*cos(thighAngle) + tibiaLength*cos(tibiaAngle)), //X location
-		tibiaLength*sin(tibiaAngle),  //Y location
-		fibulaRR->GetPos().z()),	//Z location
-		{ 1,0,0,0 }));	//rotation
-	mphysicalSystem.Add(fibulaRRJoint);
-
-
-	//to each other
-	auto fibulasLeftJoint = std::make_shared<ChLinkLockRevolute>();
-	fibulasLeftJoint->Initialize(fibulaLF, fibulaLR, ChCoordsys<>(ChVector<>(-(fibulaLength*cos(fibulaAngle) + tibiaLength*cos(tibiaAngle)), //X location
-		tibiaLength*sin(tibiaAngle) - fibulaLength*sin(fibulaAngle),  //Y location
-		fibulaLR->GetPos().z()),	//Z location
-		{ 1,0,0,0 }));	//rotation
-	mphysicalSystem.Add(fibulasLeftJoint);
-
-	auto fibulasRightJoint = std::make_shared<ChLinkLockRevolute>();
-	fibulasRightJoint->Initialize(fibulaRF, fibulaRR, ChCoordsys<>(ChVector<>(-(fibulaLength*cos(fibulaAngle) + tibiaLength*cos(tibiaAngle)), //X location
-		tibiaLength*sin(tibiaAngle) - fibulaLength*sin(fibulaAngle),  //Y location
-		fibulaRR->GetPos().z()),	//Z location
-		{ 1,0,0,0 }));	//rotation
-	mphysicalSystem.Add(fibulasRightJoint);
-
-
-
-
-
-
-
-
-
-	// Add wheels as cylinders
-	auto texture = std::make_shared<ChTexture>();
-	texture->SetTextureFilename(GetChronoDataFile("redwhite.png"));  // texture in ../data
-
-	auto wheel_0 = std::make_shared<ChBodyEasyCylinder>(wheelDia / 2.0, wheelWidth, 300,// density
-		true,// collide
-		true// visualization		
-		);
-	wheel_0->SetMass(wheelMass);
-	wheel_0->SetPos(ChVector<>(0, 0, 0));
-	wheel_0->SetRot(Q_from_AngX(CH_C_PI / 2.0));
-	mphysicalSystem.Add(wheel_0);
-	wheel_0->AddAsset(texture);
-
-	auto wheel_1 = std::make_shared<ChBodyEasyCylinder>(wheelDia/2.0, wheelWidth, 300,// density
-		true,// collide
-		true// visualization		
-		);
-	wheel_1->SetMass(wheelMass);
-	wheel_1->SetPos(ChVector<>(-(tibiaLength*cos(tibiaAngle) + fibulaLength*cos(fibulaAngle)),0,0));
-	wheel_1->SetRot(Q_from_AngX(CH_C_PI / 2.0));
-	mphysicalSystem.Add(wheel_1);
-	wheel_1->AddAsset(texture);
-
-	auto wheel_2 = std::make_shared<ChBodyEasyCylinder>(wheelDia / 2.0, wheelWidth, 300,// density
-		true,// collide
-		true// visualization		
-		);
-	wheel_2->SetMass(wheelMass);
-	wheel_2->SetPos(ChVector<>(-(2.0*tibiaLength*cos(tibiaAngle) + 2.0*fibulaLength*cos(fibulaAngle)), 0, 0));
-	wheel_2->SetRot(Q_from_AngX(CH_C_PI / 2.0));
-	mphysicalSystem.Add(wheel_2);
-	wheel_2->AddAsset(texture);
-
-	auto wheel_3 = std::make_shared<ChBodyEasyCylinder>(wheelDia / 2.0, wheelWidth, 300,// density
-		true,// collide
-		true// visualization		
-		);
-	wheel_3->SetMass(wheelMass);
-	wheel_3->SetPos(ChVector<>(0, 0, robotWidth));
-	wheel_3->SetRot(Q_from_AngX(CH_C_PI / 2.0));
-	mphysicalSystem.Add(wheel_3);
-	wheel_3->AddAsset(texture);
-
-	auto wheel_4 = std::make_shared<ChBodyEasyCylinder>(wheelDia / 2.0, wheelWidth, 300,// density
-		true,// collide
-		true// visualization		
-		);
-	wheel_4->SetMass(wheelMass);
-	wheel_4->SetPos(ChVector<>(-(tibiaLength*cos(tibiaAngle) + fibulaLength*cos(fibulaAngle)), 0, robotWidth));
-	wheel_4->SetRot(Q_from_AngX(CH_C_PI / 2.0));
-	mphysicalSystem.Add(wheel_4);
-	wheel_4->AddAsset(texture);
-
-	auto wheel_5 = std::make_shared<ChBodyEasyCylinder>(wheelDia / 2.0, wheelWidth, 300,// density
-		true,// collide
-		true// visualization		
-		);
-	wheel_5->SetMass(wheelMass);
-	wheel_5->SetPos(ChVector<>(-(2.0*tibiaLength*cos(tibiaAngle) + 2.0*fibulaLength*cos(fibulaAngle)), 0, robotWidth));
-	wheel_5->SetRot(Q_from_AngX(CH_C_PI / 2.0));
-	mphysicalSystem.Add(wheel_5);
-	wheel_5->AddAsset(texture);
-
-	//connect wheels to shins
-	auto wheel0joint = std::make_shared<ChLinkLockRevolute>();
-	wheel0joint->Initialize(tibiaLF, wheel_0, ChCoordsys<>(ChVector<>(wheel_0->GetPos().x(), wheel_0->GetPos().y(), .5*wheelWidth), { 1,0,0,0 }));
-	mphysicalSystem.Add(wheel0joint);
-
-	auto wheel1joint = std::make_shared<ChLinkLockRevolute>();
-	wheel1joint->Initialize(fibulaLF, wheel_1, ChCoordsys<>(ChVector<>(wheel_1->GetPos().x(), wheel_1->GetPos().y(), .5*wheelWidth), { 1,0,0,0 }));
-	mphysicalSystem.Add(wheel1joint);
-
-	auto wheel2joint = std::make_shared<ChLinkLockRevolute>();
-	wheel2joint->Initialize(tibiaLR, wheel_2, ChCoordsys<>(ChVector<>(wheel_2->GetPos().x(), wheel_2->GetPos().y(), .5*wheelWidth), { 1,0,0,0 }));
-	mphysicalSystem.Add(wheel2joint);
-
-	auto wheel3joint = std::make_shared<ChLinkLockRevolute>();
-	wheel3joint->Initialize(tibiaRF, wheel_3, ChCoordsys<>(ChVector<>(wheel_3->GetPos().x(), wheel_3->GetPos().y(), robotWidth - .5*wheelWidth), { 1,0,0,0 }));
-	mphysicalSystem.Add(wheel3joint);
-
-	auto wheel4joint = std::make_shared<ChLinkLockRevolute>();
-	wheel4joint->Initialize(fibulaRF, wheel_4, ChCoordsys<>(ChVector<>(wheel_4->GetPos().x(), wheel_4->GetPos().y(), robotWidth - .5*wheelWidth), { 1,0,0,0 }));
-	mphysicalSystem.Add(wheel4joint);
-
-	auto wheel5joint = std::make_shared<ChLinkLockRevolute>();
-	wheel5joint->Initialize(tibiaRR, wheel_5, ChCoordsys<>(ChVector<>(wheel_5->GetPos().x(), wheel_5->GetPos().y(), robotWidth - .5*wheelWidth), { 1,0,0,0 }));
-	mphysicalSystem.Add(wheel5joint);
-
-	//Add springs between tibia and fibulas
-	auto col_1 = std::make_shared<ChColorAsset>();
-	col_1->SetColor(ChColor(0.6f, 0, 0));
-
-	// Create right side springs
-	// Create a spring between elements 1 and 5 on the right side
-	auto springtLF = std::make_shared<ChLinkSpring>();
-	springtLF->Initialize(tibiaLF,	// first body to link it with
-		fibulaLF,	// second body to link it with
-		false,	// pos absolute
-		ChVector<>(-((tibiaLength- tibiaSpringPt)*cos(tibiaAngle)) , 
-		(tibiaLength - tibiaSpringPt)*sin(tibiaAngle), tibiaLF->GetPos().z()), // position of first end of spring
-		ChVector<>(-(tibiaLength*cos(tibiaAngle) + fibulaSpringPt*cos(fibulaAngle)), 
-		tibiaLength*sin(tibiaAngle) - fibulaSpringPt*sin(fibulaAngle), tibiaLF->GetPos().z()), // position of second end of spring
-		false,	// rest length not original length
-		restLength);	// rest length
-	mphysicalSystem.Add(springtLF);
-	springtLF->Set_SpringK(k);
-	springtLF->Set_SpringR(c);
-	// Attach a visualization asset.
-	springtLF->AddAsset(col_1);
-	springtLF->AddAsset(std::make_shared<ChPointPointSpring>(.0125, 20, 10));
-
-	auto springtLR = std::make_shared<ChLinkSpring>();
-	springtLR->Initialize(tibiaLR,	// first body to link it with
-		fibulaLR,	// second body to link it with
-		false,	// pos absolute
-		ChVector<>(-(2.0*fibulaLength*cos(fibulaAngle) + (tibiaLength + tibiaSpringPt)*cos(tibiaAngle)), 
-		(tibiaLength - tibiaSpringPt)*sin(tibiaAngle), tibiaLR->GetPos().z()), // position of first end of spring
-		ChVector<>(-(tibiaLength*cos(tibiaAngle) + (2.0*fibulaLength - fibulaSpringPt)*cos(fibulaAngle)),
-			tibiaLength*sin(tibiaAngle) - fibulaSpringPt*sin(fibulaAngle), tibiaLR->GetPos().z()), // position of second end of spring
-		false,	// rest length not original length
-		restLength);	// rest length
-	mphysicalSystem.Add(springtLR);
-	springtLR->Set_SpringK(k);
-	springtLR->Set_SpringR(c);
-	// Attach a visualization asset.
-	springtLR->AddAsset(col_1);
-	springtLR->AddAsset(std::make_shared<ChPointPointSpring>(.0125, 20, 10));
-
-	auto springtRF = std::make_shared<ChLinkSpring>();
-	springtRF->Initialize(tibiaRF,	// first body to link it with
-		fibulaRF,	// second body to link it with
-		false,	// pos absolute
-		ChVector<>(-((tibiaLength - tibiaSpringPt)*cos(tibiaAngle)), 
-		(tibiaLength - tibiaSpringPt)*sin(tibiaAngle), tibiaRF->GetPos().z()), // position of first end of spring
-		ChVector<>(-(tibiaLength*cos(tibiaAngle) + fibulaSpringPt*cos(fibulaAngle)),
-			tibiaLength*sin(tibiaAngle) - fibulaSpringPt*sin(fibulaAngle), tibiaRF->GetPos().z()), // position of second end of spring
-		false,	// rest length not original length
-		restLength);	// rest length
-	mphysicalSystem.Add(springtRF);
-	springtRF->Set_SpringK(k);
-	springtRF->Set_SpringR(c);
-	// Attach a visualization asset.
-	springtRF->AddAsset(col_1);
-	springtRF->AddAsset(std::make_shared<ChPointPointSpring>(.0125, 20, 10));
-
-	auto springtRR = std::make_shared<ChLinkSpring>();
-	springtRR->Initialize(tibiaRR,	// first body to link it with
-		fibulaRR,	// second body to link it with
-		false,	// pos absolute
-		ChVector<>(-(2.0*fibulaLength*cos(fibulaAngle) + (tibiaLength + tibiaSpringPt)*cos(tibiaAngle)), 
-		(tibiaLength - tibiaSpringPt)*sin(tibiaAngle), tibiaRR->GetPos().z()), // position of first end of spring
-		ChVector<>(-(tibiaLength*cos(tibiaAngle) + (2.0*fibulaLength-fibulaSpringPt)*cos(fibulaAngle)),
-			tibiaLength*sin(tibiaAngle) - fibulaSpringPt*sin(fibulaAngle), tibiaRR->GetPos().z()), // position of second end of spring
-		false,	// rest length not original length
-		restLength);	// rest length
-	mphysicalSystem.Add(springtRR);
-	springtRR->Set_SpringK(k);
-	springtRR->Set_SpringR(c);
-	// Attach a visualization asset.
-	springtRR->AddAsset(col_1);
-	springtRR->AddAsset(std::make_shared<ChPointPointSpring>(.0125, 20, 10));
-
-
-
-	auto obstacleBox1 = std::make_shared<ChBodyEasyBox>(.2, .1, 1.22, 1000, true, true);
-	obstacleBox1->SetMass(10.0);
-	obstacleBox1->SetPos(ChVector<>(2.0, -.3, 0));
-	mphysicalSystem.Add(obstacleBox1);
-	obstacleBox1->SetBodyFixed(true);
-	//auto obstacleColor = std::make_shared<ChColorAsset>();
-	//obstacleColor->SetColor(ChColor(0.2f, 0.1f, 0.1f));
-	auto obstacleTexture = std::make_shared<ChTexture>();
-	obstacleTexture->SetTextureFilename(GetChronoDataFile("cubetexture_wood.png"));  // texture in ../data
-	obstacleBox1->AddAsset(obstacleTexture);
-
-
-
-
-
-
-
-
-
-	//set torque on the wheels
-	wheel0joint->Set_Scr_torque(torqueLeftSide);
-	wheel1joint->Set_Scr_torque(torqueLeftSide);
-	wheel2joint->Set_Scr_torque(torqueLeftSide);
-	wheel3joint->Set_Scr_torque(torqueRightSide);
-	wheel4joint->Set_Scr_torque(torqueRightSide);
-	wheel5joint->Set_Scr_torque(torqueRightSide);
+	//-----------------------OBSTACLES------------------------------//
+	auto obstacleBox1 = AddObstacleBox(mphysicalSystem, ChVector<>(.2, .1, 1.22), ChVector<>(2.0, -.3, 0), roverParams.visualization);
 
-	
-	
+    //======================================================================
 
+	double step_size = 0.001;
+	mphysicalSystem.SetMaxItersSolverSpeed(5000);
 
-    //======================================================================
+	std::cout << "ROBOT LENGTH: " << roverParams.RobotLength() << std::endl;
+	std::cout << "ROBOT MASS: " << roverParams.RobotMass() << std::endl;
+
+	for (int i = 1; i + 1 < argc; i++)
+		if (strcmp(argv[i], "--solver-tol") == 0)
+			solverTolerance = atof(argv[i + 1]);
+	SolverStats solverStats(mphysicalSystem, solverTolerance);
+	CollisionStats collisionStats(mphysicalSystem);
+	collisionStats.WatchRover(rover);
+	for (int i = 1; i + 1 < argc; i++)
+		if (strcmp(argv[i], "--wheel-contacts") == 0)
+			wheelContactsFile = argv[i + 1];
+	WheelContactSettings contactSettings;
+	contactSettings.keepHistory = wheelContactsFile != nullptr;  //statistics only otherwise
+	WheelContacts wheelContacts(mphysicalSystem, rover, contactSettings);
+
+	for (int i = 1; i + 1 < argc; i++)
+		if (strcmp(argv[i], "--spring-telemetry") == 0)
+			springTelemetryFile = argv[i + 1];
+	SpringTelemetrySettings springSettings;
+	springSettings.keepHistory = springTelemetryFile != nullptr;  //statistics only otherwise
+	SpringTelemetry springTelemetry(rover.springs, springSettings);
+
+	for (int i = 1; i + 1 < argc; i++)
+		if (strcmp(argv[i], "--drive") == 0)
+			driveLogFile = argv[i + 1];
+	DriveCommandStream driveCommands;
+	if (driveLogFile) {
+		if (!driveCommands.Open(driveLogFile))
+			return 1;
+		if (!driveCommands.Fits(rover)) {
+			std::cerr << driveLogFile << " has " << driveCommands.NumChannels() << " channels, expected 2 (left, right) or "
+			          << rover.wheelJoints.size() << " (one per wheel)" << std::endl;
+			return 1;
+		}
+	}
+
+	for (int i = 1; i + 1 < argc; i++) {
+		if (strcmp(argv[i], "--control") == 0)
+			controlRate = atof(argv[i + 1]);
+		else if (strcmp(argv[i], "--control-speed") == 0)
+			skidSteer.speed = atof(argv[i + 1]);
+		else if (strcmp(argv[i], "--control-turn") == 0)
+			skidSteer.turn = atof(argv[i + 1]);
+		else if (strcmp(argv[i], "--control-slip") == 0)
+			controlSlip = atof(argv[i + 1]);
+	}
+	if (controlRate > 0 && driveLogFile) {
+		std::cerr << "--control and --drive both set the wheel torques, use one of them" << std::endl;
+		return 1;
+	}
+	TractionControl<SkidSteerController> controller(skidSteer, controlSlip);
+	ControlLoop<TractionControl<SkidSteerController>> controlLoop(rover, mphysicalSystem, controller,
+	                                                              controlRate > 0 ? controlRate : 1);
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--bridge") == 0 && i + 1 < argc)
+			bridgeName = argv[i + 1];
+		else if (strcmp(argv[i], "--bridge-lockstep") == 0)
+			bridgeSettings.lockstep = true;
+		else if (strcmp(argv[i], "--bridge-ring") == 0 && i + 1 < argc)
+			bridgeSettings.ringSize = (uint32_t)std::max(1, atoi(argv[i + 1]));
+		else if (strcmp(argv[i], "--bridge-timeout") == 0 && i + 1 < argc)
+			bridgeSettings.timeout = atof(argv[i + 1]);
+	}
+	if (bridgeName && (driveLogFile || controlRate > 0)) {
+		std::cerr << "--bridge, --control and --drive all set the wheel torques, use one of them" << std::endl;
+		return 1;
+	}
+	ShmBridge bridge;
+	if (bridgeName && !bridge.Create(bridgeName, bridgeSettings))
+		return 1;
+
+#ifdef ROVER_HEADLESS
+	//
+	// HEADLESS BATCH RUN -> no Irrlicht device, step as fast as the solver allows
+	//
+	int numPositional = 0;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--trajectory") == 0 && i + 1 < argc)
+			trajectoryFile = argv[++i];
+		else if (strcmp(argv[i], "--adaptive") == 0 && i + 2 < argc) {
+			adaptiveStep = true;
+			adaptiveSettings.minStep = atof(argv[++i]);
+			adaptiveSettings.maxStep = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--step-history") == 0 && i + 1 < argc)
+			stepHistoryFile = argv[++i];
+		else if (strcmp(argv[i], "--solver-tol") == 0 && i + 1 < argc)
+			i++;  //read above
+		else if (strcmp(argv[i], "--self-collision") == 0)
+			continue;  //read above
+		else if ((strcmp(argv[i], "--drive") == 0 || strcmp(argv[i], "--control") == 0 ||
+		          strcmp(argv[i], "--control-speed") == 0 || strcmp(argv[i], "--control-turn") == 0 ||
+		          strcmp(argv[i], "--control-slip") == 0) && i + 1 < argc)
+			i++;  //read above
+		else if (strcmp(argv[i], "--bridge-lockstep") == 0)
+			continue;  //read above
+		else if ((strcmp(argv[i], "--bridge") == 0 || strcmp(argv[i], "--bridge-ring") == 0 ||
+		          strcmp(argv[i], "--bridge-timeout") == 0) && i + 1 < argc)
+			i++;  //read above
+		else if (strcmp(argv[i], "--load-checkpoint") == 0 && i + 1 < argc)
+			loadCheckpointFile = argv[++i];
+		else if (strcmp(argv[i], "--save-checkpoint") == 0 && i + 1 < argc)
+			saveCheckpointFile = argv[++i];
+		else if (strcmp(argv[i], "--pose-cache") == 0 && i + 1 < argc)
+			poseCacheDir = argv[++i];
+		else if ((strcmp(argv[i], "--wheel-contacts") == 0 || strcmp(argv[i], "--spring-telemetry") == 0) && i + 1 < argc)
+			i++;  //read above
+		else if (strcmp(argv[i], "--realtime") == 0 && i + 1 < argc) {
+			realtime = true;
+			pacerSettings.realTimeFactor = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--pace-batch") == 0 && i + 1 < argc)
+			pacerSettings.batchSteps = atoi(argv[++i]);
+		else if (strncmp(argv[i], "--", 2) == 0 || numPositional >= 2) {
+			std::cerr << "Unknown or incomplete argument " << argv[i] << std::endl;
+			headlessDuration = 0;  //-> usage below
+			break;
+		} else if (numPositional++ == 0)
+			headlessDuration = atof(argv[i]);
+		else
+			step_size = atof(argv[i]);
+	}
+	if (headlessDuration <= 0 || step_size <= 0) {
+		std::cerr << "usage: " << argv[0] << " [duration in seconds] [step size in seconds] [--trajectory file]"
+		          << " [--adaptive min max] [--step-history file] [--solver-tol tol]"
+		          << " [--load-checkpoint file] [--save-checkpoint file] [--pose-cache dir] [--self-collision]"
+		          << " [--realtime factor] [--pace-batch n] [--drive file]"
+		          << " [--control hz] [--control-speed w] [--control-turn w] [--control-slip w]"
+		          << " [--bridge name] [--bridge-lockstep] [--bridge-ring n] [--bridge-timeout s]"
+		          << " [--wheel-contacts file] [--spring-telemetry file]" << std::endl;
+		return 1;
+	}
+	if (realtime && (pacerSettings.realTimeFactor <= 0 || pacerSettings.batchSteps < 1 || adaptiveStep)) {
+		std::cerr << "--realtime needs a positive factor, --pace-batch at least 1 and a fixed step" << std::endl;
+		return 1;
+	}
+	if (adaptiveStep && (adaptiveSettings.minStep <= 0 || adaptiveSettings.maxStep < adaptiveSettings.minStep)) {
+		std::cerr << "--adaptive needs 0 < min <= max" << std::endl;
+		return 1;
+	}
+
+	if (loadCheckpointFile && !LoadCheckpoint(mphysicalSystem, loadCheckpointFile))
+		return 1;
+	if (!loadCheckpointFile && poseCacheDir)
+		SeedSettledRoverD(mphysicalSystem, rover, roverParams, -.3, poseCacheDir);
+	double endTime = mphysicalSystem.GetChTime() + headlessDuration;
+
+	double minStep = adaptiveStep ? adaptiveSettings.minStep : step_size;
+	TrajectoryWriter trajectory;
+	if (trajectoryFile) {
+		if (!trajectory.Open(trajectoryFile, mphysicalSystem, step_size, (uint64_t)(headlessDuration / minStep) + 2))
+			return 1;
+		trajectory.Append();
+	}
+
+	adaptiveSettings.initialStep = step_size;
+	AdaptiveStepper stepper(mphysicalSystem, adaptiveSettings);
+	stepper.WatchSprings(rover.springs);
+	wheelContacts.Reserve((size_t)(headlessDuration / minStep) + 1);
+	springTelemetry.Reserve((size_t)(headlessDuration / minStep) + 1);
+
+	RealtimePacer pacer(mphysicalSystem, pacerSettings);
+
+	ChVector<> startPos = chassis->GetPos();
+	long int numSteps = 0;
+	auto wallStart = std::chrono::steady_clock::now();
+
+	while (mphysicalSystem.GetChTime() < endTime - 0.5 * minStep) {
+		if (driveLogFile)
+			driveCommands.Apply(rover, mphysicalSystem.GetChTime());
+		if (controlRate > 0)
+			controlLoop.BeforeStep();
+		if (bridgeName && !bridge.BeforeStep(rover, mphysicalSystem))
+			return 1;
+		if (adaptiveStep)
+			stepper.AdvanceTo(std::min(endTime, mphysicalSystem.GetChTime() + stepper.CurrentStep()));
+		else if (realtime)
+			pacer.Step(step_size);
+		else
+			mphysicalSystem.DoStepDynamics(step_size);
+		if (controlRate > 0)
+			controlLoop.AfterStep();
+		if (bridgeName)
+			bridge.AfterStep(rover, mphysicalSystem);
+		solverStats.Record();
+		collisionStats.Record();
+		wheelContacts.Record();
+		springTelemetry.Record(mphysicalSystem.GetChTime());
+		numSteps++;
+		if (trajectoryFile)
+			trajectory.Append();
+	}
+	trajectory.Close();
+
+	double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+	ChVector<> endPos = chassis->GetPos();
+
+	std::cout << "SIM TIME: " << mphysicalSystem.GetChTime() << " s" << std::endl;
+	std::cout << "STEPS: " << numSteps << " (step size " << step_size << " s)" << std::endl;
+	std::cout << "WALL TIME: " << wallTime << " s" << std::endl;
+	std::cout << "REAL TIME FACTOR: " << (wallTime > 0 ? mphysicalSystem.GetChTime() / wallTime : 0) << std::endl;
+	std::cout << "CHASSIS START: " << startPos.x() << " " << startPos.y() << " " << startPos.z() << std::endl;
+	std::cout << "CHASSIS END: " << endPos.x() << " " << endPos.y() << " " << endPos.z() << std::endl;
+	std::cout << "DISTANCE TRAVELED (X): " << endPos.x() - startPos.x() << " m" << std::endl;
+
+	solverStats.PrintSummary(std::cout);
+	collisionStats.PrintSummary(std::cout);
+	wheelContacts.PrintSummary(std::cout);
+	springTelemetry.PrintSummary(std::cout);
+	if (realtime)
+		pacer.PrintSummary(std::cout);
+	if (driveLogFile)
+		driveCommands.PrintSummary(std::cout);
+	if (controlRate > 0) {
+		controlLoop.PrintSummary(std::cout);
+		if (controlSlip > 0)
+			std::cout << "TRACTION CONTROL: " << controller.Interventions() << " torque cuts" << std::endl;
+	}
+	if (bridgeName)
+		bridge.PrintSummary(std::cout);
+
+	if (saveCheckpointFile) {
+		if (!SaveCheckpoint(mphysicalSystem, saveCheckpointFile))
+			return 1;
+		std::cout << "CHECKPOINT SAVED: " << saveCheckpointFile << " at t = " << mphysicalSystem.GetChTime() << std::endl;
+	}
+
+	if (wheelContactsFile) {
+		std::ofstream contactsCsv(wheelContactsFile);
+		wheelContacts.WriteCsv(contactsCsv);
+	}
+	if (springTelemetryFile) {
+		std::ofstream springCsv(springTelemetryFile);
+		springTelemetry.WriteCsv(springCsv);
+	}
+
+	if (adaptiveStep) {
+		stepper.PrintSummary(std::cout);
+		if (stepHistoryFile) {
+			std::ofstream history(stepHistoryFile);
+			stepper.WriteHistoryCsv(history);
+		}
+	}
+#else
+	// Draw at a fixed sim-time interval instead of once per physics step. Set up before AssetBindAll,
+	// which binds the display proxies with --threaded.
+	RenderControl renderControl(&mphysicalSystem, &displaySystem);
+	renderControl.ParseArgs(argc, argv);
+	application.SetUserEventReceiver(&renderControl);
 
     // Use this function for adding a ChIrrNodeAsset to all items
     // Otherwise use application.AssetBind(myitem); on a per-item basis.
@@ -640,38 +432,78 @@ int main(int argc, char* argv[]) {
     application.AssetUpdateAll();
 
     // Adjust some settings:
-	double step_size = 0.001;
-    application.SetTimestep(0.001);
+    application.SetTimestep(step_size);
     application.SetTryRealtime(false);
-	mphysicalSystem.SetMaxItersSolverSpeed(5000);
+
+	// Optional offscreen capture of every drawn frame, encoded in the background
+	FrameCapture frameCapture(application);
+	frameCapture.ParseArgs(argc, argv);
+	if (!frameCapture.Start(renderControl))
+		return 1;
+
+	if (driveLogFile)
+		driveCommands.Apply(rover, mphysicalSystem.GetChTime());
+	if (controlRate > 0)
+		controlLoop.BeforeStep();
+	if (bridgeName && !bridge.BeforeStep(rover, mphysicalSystem))
+		return 1;
 
     //
     // THE SOFT-REAL-TIME CYCLE
     //
-
-	//calculate robot mass as given from parameters
-	double robotMass = 6 * wheelMass + 4 * tibiaMass + 4 * fibulaMass + 4 * thighMass + chassisMass;
-
-	std::cout << "ROBOT LENGTH: " << robotLength << std::endl;
-	std::cout << "ROBOT MASS: " << robotMass << std::endl;
-
-	bool sim = true;
     while (application.GetDevice()->run()) {
-        application.BeginScene();
-
-        application.DrawAll();
-
-        // This performs the integration timestep!
+        // This performs the integration timesteps up to the next frame!
         //application.DoStep();
-		if (sim) {
-			mphysicalSystem.DoStepDynamics(step_size);
-			sim = false;
-		}
-
-		mphysicalSystem.DoStepDynamics(step_size);
+		if (!renderControl.Advance(step_size, [&]() {
+			if (controlRate > 0)
+				controlLoop.AfterStep();
+			solverStats.Record();
+			collisionStats.Record();
+			wheelContacts.Record();
+			springTelemetry.Record(mphysicalSystem.GetChTime());
+			if (driveLogFile)
+				driveCommands.Apply(rover, mphysicalSystem.GetChTime());
+			if (controlRate > 0)
+				controlLoop.BeforeStep();
+			if (bridgeName) {
+				bridge.AfterStep(rover, mphysicalSystem);
+				bridge.BeforeStep(rover, mphysicalSystem);
+			}
+		}))
+			continue;
 
+        application.BeginScene();
+		frameCapture.BeginFrame();
+        application.DrawAll();
+		frameCapture.EndFrame(renderControl.FrameTime());
         application.EndScene();
     }
+	renderControl.Stop();
+
+	solverStats.PrintSummary(std::cout);
+	collisionStats.PrintSummary(std::cout);
+	wheelContacts.PrintSummary(std::cout);
+	springTelemetry.PrintSummary(std::cout);
+	renderControl.PrintSummary(std::cout);
+	frameCapture.PrintSummary(std::cout);
+	if (driveLogFile)
+		driveCommands.PrintSummary(std::cout);
+	if (controlRate > 0) {
+		controlLoop.PrintSummary(std::cout);
+		if (controlSlip > 0)
+			std::cout << "TRACTION CONTROL: " << controller.Interventions() << " torque cuts" << std::endl;
+	}
+	if (bridgeName)
+		bridge.PrintSummary(std::cout);
+	if (wheelContactsFile) {
+		std::ofstream contactsCsv(wheelContactsFile);
+		wheelContacts.WriteCsv(contactsCsv);
+	}
+	if (springTelemetryFile) {
+		std::ofstream springCsv(springTelemetryFile);
+		springTelemetry.WriteCsv(springCsv);
+	}
+#endif
 
     return 0;
 }
@@ -0,0 +1,126 @@
+// =============================================================================
+// Parallel parameter sweep over the roverD design.
+//
+// usage: roverD_sweep <sweep file> <results.csv> [--duration s] [--step s] [--threads n]
+//                     [--adaptive min max] [--solver-tol tol] [--solver-stats]
+//                     [--checkpoint file] [--pose-cache dir]
+//
+// The sweep file is a grid or a list of parameter sets (see sweep_spec.h).
+// Every run builds its own ChSystemNSC and runs headless on a work-stealing
+// thread pool. One result row is appended to the results file as each run finishes. With --adaptive
+// the step size varies between min and max (see adaptive_step.h), with
+// --solver-tol the speed solver stops on a residual tolerance (solver_stats.h).
+// Solver iterations per step are only recorded with --solver-tol or
+// --solver-stats.
+// With --checkpoint every run starts from a settled pose saved by
+// roverD_headless --save-checkpoint, so only parameters that do not change
+// the link geometry (torques, k, c, ...) should be swept. With --pose-cache
+// every run starts from the settled pose of its own parameters, settled once
+// and cached in dir (see pose_cache.h).
+// =============================================================================
+
+#include "checkpoint.h"
+#include "rover_run.h"
+#include "sweep_spec.h"
+#include "thread_pool.h"
+
+#include "chrono/physics/ChSystemNSC.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace chrono;
+
+int main(int argc, char* argv[]) {
+    SetChronoDataPath(CHRONO_DATA_DIR);
+
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <sweep file> <results.csv> [--duration s] [--step s] [--threads n]"
+                  << " [--adaptive min max] [--solver-tol tol] [--solver-stats] [--checkpoint file] [--pose-cache dir]"
+                  << std::endl;
+        return 1;
+    }
+
+    RunSettings settings;
+    unsigned numThreads = 0;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--solver-stats") == 0)
+            settings.solverStats = true;
+        else if (i + 1 >= argc)
+            break;
+        else if (strcmp(argv[i], "--duration") == 0)
+            settings.duration = atof(argv[++i]);
+        else if (strcmp(argv[i], "--step") == 0)
+            settings.step_size = atof(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0)
+            numThreads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--adaptive") == 0 && i + 2 < argc) {
+            settings.adaptive = true;
+            settings.minStep = atof(argv[++i]);
+            settings.maxStep = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--solver-tol") == 0) {
+            settings.solverTolerance = atof(argv[++i]);
+            settings.solverStats = true;
+        } else if (strcmp(argv[i], "--checkpoint") == 0)
+            settings.checkpoint = argv[++i];
+        else if (strcmp(argv[i], "--pose-cache") == 0)
+            settings.poseCache = argv[++i];
+    }
+
+    SweepSpec spec;
+    if (!ReadSweepSpec(argv[1], spec))
+        return 1;
+
+    //fail once here rather than in every run
+    if (!settings.checkpoint.empty()) {
+        ChSystemNSC check;
+        BuildRoverDScene(check, RoverDParameters(), settings);
+        if (!LoadCheckpoint(check, settings.checkpoint))
+            return 1;
+    }
+
+    std::ofstream results(argv[2]);
+    if (!results) {
+        std::cerr << "Could not open " << argv[2] << std::endl;
+        return 1;
+    }
+    results << "run";
+    for (const auto& name : spec.names)
+        results << ',' << name;
+    results << ',';
+    RunResult::WriteCsvHeader(results);
+    results << std::endl;
+
+    WorkStealingPool pool(numThreads);
+    std::cout << "Sweep: " << spec.runs.size() << " runs of " << settings.duration << " s on " << pool.Size()
+              << " threads" << std::endl;
+
+    std::mutex resultsMutex;
+    size_t finished = 0;
+
+    for (size_t r = 0; r < spec.runs.size(); r++) {
+        pool.Submit([&, r]() {
+            RunResult result = RunRoverD(spec.Parameters(r), settings);
+
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            results << r;
+            for (double value : spec.runs[r])
+                results << ',' << value;
+            results << ',';
+            result.WriteCsv(results);
+            results << std::endl;
+
+            finished++;
+            std::cout << "Run " << r << " done (" << finished << "/" << spec.runs.size() << "), distance "
+                      << result.distance << " m, wall " << result.wallTime << " s" << std::endl;
+        });
+    }
+    pool.Wait();
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+// =============================================================================
+// Long range roverD traverse over tiled heightfield terrain.
+//
+// usage: roverD_traverse <heightmap.pgm> [--duration s] [--step s] [--cell m]
+//                        [--height-scale m] [--tile cells] [--load-radius m]
+//                        [--evict-radius m]
+//
+// The rover starts at the center of the raster and drives along +X. Only the
+// terrain tiles around the chassis are kept in the system (see terrain.h).
+// Runs headless and stops early if the rover reaches the edge of the raster.
+// =============================================================================
+
+#include "chrono/physics/ChSystemNSC.h"
+
+#include "rover_model.h"
+#include "terrain.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace chrono;
+
+int main(int argc, char* argv[]) {
+    SetChronoDataPath(CHRONO_DATA_DIR);
+
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <heightmap.pgm> [--duration s] [--step s] [--cell m] [--height-scale m]"
+                  << " [--tile cells] [--load-radius m] [--evict-radius m]" << std::endl;
+        return 1;
+    }
+
+    double duration = 60;
+    double step_size = 0.001;
+    TerrainSettings terrainSettings;
+    for (int i = 2; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--duration") == 0)
+            duration = atof(argv[++i]);
+        else if (strcmp(argv[i], "--step") == 0)
+            step_size = atof(argv[++i]);
+        else if (strcmp(argv[i], "--cell") == 0)
+            terrainSettings.cellSize = atof(argv[++i]);
+        else if (strcmp(argv[i], "--height-scale") == 0)
+            terrainSettings.heightScale = atof(argv[++i]);
+        else if (strcmp(argv[i], "--tile") == 0)
+            terrainSettings.tileCells = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--load-radius") == 0)
+            terrainSettings.loadRadius = atof(argv[++i]);
+        else if (strcmp(argv[i], "--evict-radius") == 0)
+            terrainSettings.evictRadius = atof(argv[++i]);
+    }
+    if (duration <= 0 || step_size <= 0 || terrainSettings.cellSize <= 0 || terrainSettings.tileCells < 1 ||
+        terrainSettings.evictRadius < terrainSettings.loadRadius) {
+        std::cerr << "Invalid settings (evict radius must be at least the load radius)" << std::endl;
+        return 1;
+    }
+
+    ChSystemNSC mphysicalSystem;
+    mphysicalSystem.SetMaxItersSolverSpeed(5000);
+
+    RoverDParameters roverParams;
+    roverParams.visualization = false;
+
+    TiledTerrain terrain(mphysicalSystem, terrainSettings);
+    if (!terrain.Load(argv[1]))
+        return 1;
+
+    //put the middle of the raster under the rover, then lower the terrain so its highest point under
+    //the rover footprint is where the roverD floor would be (y = -.3)
+    ChVector<> origin(-terrain.SizeX() / 2.0, 0, -terrain.SizeZ() / 2.0 + roverParams.robotWidth / 2.0);
+    terrain.SetOrigin(origin);
+    double highest = -1e30;
+    for (double x = -roverParams.RobotLength() - .5; x <= .5; x += terrainSettings.cellSize)
+        for (double z = -.5; z <= roverParams.robotWidth + .5; z += terrainSettings.cellSize)
+            highest = std::max(highest, terrain.HeightAt(x, z));
+    origin.y() = -.3 - highest;
+    terrain.SetOrigin(origin);
+
+    RoverModel rover = BuildRoverD(mphysicalSystem, roverParams);
+    auto chassis = rover.chassis;
+    terrain.Update(chassis->GetPos());
+
+    std::cout << "TERRAIN: " << terrain.SizeX() << " x " << terrain.SizeZ() << " m, tiles of "
+              << terrainSettings.tileCells * terrainSettings.cellSize << " m" << std::endl;
+
+    double edgeX = origin.x() + terrain.SizeX() - terrainSettings.loadRadius;
+    ChVector<> startPos = chassis->GetPos();
+    long numSteps = 0;
+    auto wallStart = std::chrono::steady_clock::now();
+
+    while (mphysicalSystem.GetChTime() < duration - 0.5 * step_size) {
+        mphysicalSystem.DoStepDynamics(step_size);
+        terrain.Update(chassis->GetPos());
+        numSteps++;
+
+        if (chassis->GetPos().x() > edgeX) {
+            std::cout << "Reached the edge of the terrain" << std::endl;
+            break;
+        }
+    }
+
+    double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    ChVector<> endPos = chassis->GetPos();
+
+    std::cout << "SIM TIME: " << mphysicalSystem.GetChTime() << " s" << std::endl;
+    std::cout << "STEPS: " << numSteps << std::endl;
+    std::cout << "WALL TIME: " << wallTime << " s" << std::endl;
+    std::cout << "REAL TIME FACTOR: " << (wallTime > 0 ? mphysicalSystem.GetChTime() / wallTime : 0) << std::endl;
+    std::cout << "DISTANCE TRAVELED (X): " << endPos.x() - startPos.x() << " m" << std::endl;
+    std::cout << "TILES LOADED: " << terrain.TilesLoaded() << ", EVICTED: " << terrain.TilesEvicted()
+              << ", PEAK IN SYSTEM: " << terrain.PeakLoadedTiles() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "scene_snapshot.h"
+
+#include "chrono/assets/ChPointPointDrawing.h"
+
+using namespace chrono;
+
+SnapshotBuffer::SnapshotBuffer(size_t numBodies) {
+    for (auto& snapshot : buffers)
+        snapshot.bodyPoses.resize(numBodies);
+}
+
+void SnapshotBuffer::Publish() {
+    published++;
+    back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+}
+
+const SceneSnapshot* SnapshotBuffer::Latest() {
+    if (!(middle.load(std::memory_order_acquire) & FRESH))
+        return nullptr;
+    front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+    taken++;
+    return &buffers[front];
+}
+
+//the drawings recompute their line from the link they belong to -> the proxy springs need their own copies
+static std::shared_ptr<ChAsset> DisplayCopy(const std::shared_ptr<ChAsset>& asset) {
+    if (auto spring = std::dynamic_pointer_cast<ChPointPointSpring>(asset))
+        return std::make_shared<ChPointPointSpring>(*spring);
+    if (auto segment = std::dynamic_pointer_cast<ChPointPointSegment>(asset))
+        return std::make_shared<ChPointPointSegment>(*segment);
+    return asset;
+}
+
+SceneMirror::SceneMirror(ChSystem& physics, ChSystem& display) : display(display) {
+    for (const auto& body : physics.Get_bodylist()) {
+        auto proxy = std::make_shared<ChBody>();
+        proxy->SetBodyFixed(true);
+        proxy->SetCollide(false);
+        proxy->SetCoord(body->GetCoord());
+        for (const auto& asset : body->GetAssets())
+            proxy->AddAsset(asset);
+        display.AddBody(proxy);
+        sources.push_back(body);
+        proxies.push_back(proxy);
+    }
+
+    //springs are the only links with drawings
+    for (const auto& link : physics.Get_linklist()) {
+        auto spring = std::dynamic_pointer_cast<ChLinkSpring>(link);
+        if (!spring)
+            continue;
+        std::shared_ptr<ChBody> body1, body2;
+        for (size_t i = 0; i < sources.size(); i++) {
+            if (spring->GetBody1() == sources[i].get())
+                body1 = proxies[i];
+            if (spring->GetBody2() == sources[i].get())
+                body2 = proxies[i];
+        }
+        if (!body1 || !body2)
+            continue;
+        auto proxy = std::make_shared<ChLinkSpring>();
+        proxy->Initialize(body1, body2, false, spring->GetEndPoint1Abs(), spring->GetEndPoint2Abs());
+        for (const auto& asset : spring->GetAssets())
+            proxy->AddAsset(DisplayCopy(asset));
+        display.AddLink(proxy);
+    }
+}
+
+void SceneMirror::Capture(SceneSnapshot& snapshot) const {
+    for (size_t i = 0; i < sources.size(); i++)
+        snapshot.bodyPoses[i] = sources[i]->GetCoord();
+}
+
+void SceneMirror::Apply(const SceneSnapshot& snapshot) {
+    for (size_t i = 0; i < proxies.size(); i++)
+        proxies[i]->SetCoord(snapshot.bodyPoses[i]);
+    display.SetChTime(snapshot.time);
+    display.Update(true);
+}
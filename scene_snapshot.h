@@ -0,0 +1,79 @@
+// =============================================================================
+// Body pose snapshots handed from the physics thread to the render thread.
+//
+// SceneMirror builds a display-only copy of a system: one fixed,
+// non-colliding proxy body per body, carrying the same visualization assets,
+// and one proxy spring per ChLinkSpring so the spring drawings follow the
+// proxies. Irrlicht is bound to the display system, so drawing never reads
+// a body the solver is writing. The physics thread captures every body pose
+// into a SceneSnapshot; the render thread applies the latest one to the
+// proxies before drawing.
+//
+// SnapshotBuffer is a lock-free triple buffer: the writer always has a back
+// snapshot to fill, the reader always owns a front one, and the middle one
+// is swapped with an atomic exchange. Neither side ever waits, and the
+// reader only sees complete snapshots. All three are allocated up front.
+// =============================================================================
+
+#ifndef SCENE_SNAPSHOT_H
+#define SCENE_SNAPSHOT_H
+
+#include "chrono/physics/ChSystem.h"
+#include "chrono/physics/ChLinkSpring.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+struct SceneSnapshot {
+    double time = 0;
+    long step = 0;                                  //physics steps taken when captured
+    std::vector<chrono::ChCoordsys<>> bodyPoses;    //in system body order
+};
+
+class SnapshotBuffer {
+  public:
+    SnapshotBuffer(size_t numBodies);
+
+    //writer side: fill Back(), then Publish() it
+    SceneSnapshot& Back() { return buffers[back]; }
+    void Publish();
+
+    //reader side: the newest published snapshot, or nullptr if nothing new since the last call.
+    //The snapshot stays valid until the next call.
+    const SceneSnapshot* Latest();
+
+    long Published() const { return published; }
+    long Taken() const { return taken; }
+
+  private:
+    static const int FRESH = 4;   //middle snapshot not taken yet
+    static const int INDEX = 3;
+
+    SceneSnapshot buffers[3];
+    int back = 0;                     //writer only
+    int front = 1;                    //reader only
+    std::atomic<int> middle{2};       //index | FRESH
+    long published = 0;
+    long taken = 0;
+};
+
+class SceneMirror {
+  public:
+    //adds the proxies for everything currently in physics to display
+    SceneMirror(chrono::ChSystem& physics, chrono::ChSystem& display);
+
+    size_t NumBodies() const { return sources.size(); }
+
+    //physics thread: copy every body pose
+    void Capture(SceneSnapshot& snapshot) const;
+    //render thread: move the proxies and update the spring drawings
+    void Apply(const SceneSnapshot& snapshot);
+
+  private:
+    chrono::ChSystem& display;
+    std::vector<std::shared_ptr<chrono::ChBody>> sources;
+    std::vector<std::shared_ptr<chrono::ChBody>> proxies;
+};
+
+#endif
@@ -0,0 +1,324 @@
+#include "shm_bridge.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace chrono;
+
+//header, then each ring's slots starting on a cache line
+static size_t StatesOffset() {
+    return (sizeof(ShmBridgeHeader) + 63) & ~(size_t)63;
+}
+
+static size_t CommandsOffset(uint32_t ringSize) {
+    return StatesOffset() + ((ringSize * sizeof(BridgeState) + 63) & ~(size_t)63);
+}
+
+static size_t RegionSize(uint32_t ringSize) {
+    return CommandsOffset(ringSize) + ringSize * sizeof(BridgeCommand);
+}
+
+SharedRegion::~SharedRegion() {
+    Close();
+}
+
+#ifdef _WIN32
+
+bool SharedRegion::Create(const std::string& regionName, size_t regionSize) {
+    Close();
+    name = regionName[0] == '/' ? regionName.substr(1) : regionName;
+    mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)((uint64_t)regionSize >> 32),
+                                 (DWORD)(regionSize & 0xffffffff), name.c_str());
+    if (!mapping)
+        return false;
+    data = (char*)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, regionSize);
+    if (!data) {
+        Close();
+        return false;
+    }
+    memset(data, 0, regionSize);
+    size = regionSize;
+    owner = true;
+    return true;
+}
+
+bool SharedRegion::Open(const std::string& regionName) {
+    Close();
+    name = regionName[0] == '/' ? regionName.substr(1) : regionName;
+    mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    if (!mapping)
+        return false;
+    data = (char*)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (!data) {
+        Close();
+        return false;
+    }
+    MEMORY_BASIC_INFORMATION info;
+    VirtualQuery(data, &info, sizeof(info));
+    size = info.RegionSize;
+    return true;
+}
+
+void SharedRegion::Close() {
+    if (data)
+        UnmapViewOfFile(data);
+    if (mapping)
+        CloseHandle(mapping);
+    data = nullptr;
+    mapping = nullptr;
+    size = 0;
+    owner = false;
+}
+
+#else
+
+bool SharedRegion::Create(const std::string& regionName, size_t regionSize) {
+    Close();
+    name = regionName[0] == '/' ? regionName : "/" + regionName;
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+    if (fd < 0)
+        return false;
+    //a fresh ftruncate zero-fills the region
+    if (ftruncate(fd, (off_t)regionSize) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void* mapped = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return false;
+    }
+    data = (char*)mapped;
+    size = regionSize;
+    owner = true;
+    return true;
+}
+
+bool SharedRegion::Open(const std::string& regionName) {
+    Close();
+    name = regionName[0] == '/' ? regionName : "/" + regionName;
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+        return false;
+    data = (char*)mapped;
+    size = (size_t)info.st_size;
+    return true;
+}
+
+void SharedRegion::Close() {
+    if (data)
+        munmap(data, size);
+    if (owner)
+        shm_unlink(name.c_str());
+    data = nullptr;
+    size = 0;
+    owner = false;
+}
+
+#endif
+
+bool ShmBridge::Create(const std::string& regionName, const ShmBridgeSettings& bridgeSettings) {
+    settings = bridgeSettings;
+    name = regionName;
+    uint32_t ringSize = 1;
+    while (ringSize < settings.ringSize)
+        ringSize *= 2;
+    settings.ringSize = ringSize;
+
+    if (!region.Create(name, RegionSize(ringSize))) {
+        std::cerr << "Could not create shared memory " << name << std::endl;
+        return false;
+    }
+    header = new (region.Data()) ShmBridgeHeader();
+    memcpy(header->magic, "ROVSHM01", 8);
+    header->version = 1;
+    header->ringSize = ringSize;
+    header->lockstep = settings.lockstep ? 1 : 0;
+    states = ShmRing<BridgeState>(&header->states, (BridgeState*)(region.Data() + StatesOffset()), ringSize);
+    commands =
+        ShmRing<BridgeCommand>(&header->commands, (BridgeCommand*)(region.Data() + CommandsOffset(ringSize)), ringSize);
+    header->ready.store(1, std::memory_order_release);
+    return true;
+}
+
+ShmBridge::~ShmBridge() {
+    if (header)
+        header->ready.store(0, std::memory_order_release);
+}
+
+bool ShmBridge::TakeCommands() {
+    bool any = false;
+    BridgeCommand received;
+    while (commands.Pop(received)) {
+        commandsReceived++;
+        if (settings.lockstep && received.sequence < sequence)
+            staleCommands++;
+        if (!haveCommand || received.sequence >= command.sequence)
+            command = received;
+        haveCommand = true;
+        any = true;
+    }
+    return any;
+}
+
+bool ShmBridge::BeforeStep(RoverModel& rover, const ChSystem& system) {
+    //the client answers the state before the first step too
+    if (!started) {
+        if (settings.lockstep) {
+            auto start = std::chrono::steady_clock::now();
+            while (!header->clientAttached.load(std::memory_order_acquire)) {
+                if (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > settings.attachTimeout) {
+                    std::cerr << "No client attached to " << name << " within " << settings.attachTimeout << " s" << std::endl;
+                    return false;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        started = true;
+        Publish(rover, system);
+    }
+
+    if (settings.lockstep) {
+        auto start = std::chrono::steady_clock::now();
+        while (true) {
+            TakeCommands();
+            if (haveCommand && command.sequence == sequence)
+                break;
+            if (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > settings.timeout) {
+                timeouts++;
+                break;
+            }
+            std::this_thread::yield();
+        }
+        answerWait.Add(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    } else
+        TakeCommands();
+
+    if (haveCommand) {
+        for (int i = 0; i < RoverState::maxWheels; i++)
+            roverCommand.torque[i] = command.torque[i];
+        ApplyRoverCommand(rover, roverCommand);
+    }
+    return true;
+}
+
+void ShmBridge::AfterStep(const RoverModel& rover, const ChSystem& system) {
+    sequence++;
+    Publish(rover, system);
+}
+
+void ShmBridge::Publish(const RoverModel& rover, const ChSystem& system) {
+    auto start = std::chrono::steady_clock::now();
+    ReadRoverState(rover, system, roverState);
+
+    state.sequence = sequence;
+    state.time = roverState.time;
+    const ChVector<>* vectors[4] = { &roverState.position, &roverState.velocity, &roverState.angularRate,
+                                     &roverState.specificForce };
+    double* targets[4] = { state.position, state.velocity, state.angularRate, state.specificForce };
+    for (int v = 0; v < 4; v++) {
+        targets[v][0] = vectors[v]->x();
+        targets[v][1] = vectors[v]->y();
+        targets[v][2] = vectors[v]->z();
+    }
+    state.rotation[0] = roverState.rotation.e0();
+    state.rotation[1] = roverState.rotation.e1();
+    state.rotation[2] = roverState.rotation.e2();
+    state.rotation[3] = roverState.rotation.e3();
+    state.numWheels = roverState.numWheels;
+    state.numLeftWheels = roverState.numLeftWheels;
+    for (int i = 0; i < RoverState::maxWheels; i++) {
+        state.wheelSpeed[i] = roverState.wheelSpeed[i];
+        state.wheelTorque[i] = roverCommand.torque[i];
+    }
+
+    if (states.Push(state))
+        published++;
+    else
+        dropped++;
+    publishTime.Add(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
+
+void ShmBridge::PrintSummary(std::ostream& out) const {
+    out << "BRIDGE: " << name << " (" << (settings.lockstep ? "lockstep" : "free running") << ", rings of "
+        << settings.ringSize << ")" << std::endl;
+    out << "BRIDGE STATES: " << published << " published, " << dropped << " dropped with the ring full" << std::endl;
+    out << "BRIDGE COMMANDS: " << commandsReceived << " received";
+    if (settings.lockstep)
+        out << ", " << staleCommands << " late, " << timeouts << " steps timed out";
+    out << std::endl;
+    out << "BRIDGE PUBLISH (us): mean " << publishTime.Mean() * 1e6 << " max " << publishTime.Max() * 1e6 << std::endl;
+    if (settings.lockstep)
+        out << "BRIDGE ROUND TRIP (us, waiting for the answer): mean " << answerWait.Mean() * 1e6 << " max "
+            << answerWait.Max() * 1e6 << std::endl;
+}
+
+bool ShmBridgeClient::Attach(const std::string& name, double timeout) {
+    auto start = std::chrono::steady_clock::now();
+    while (true) {
+        if (region.Open(name) && region.Size() >= sizeof(ShmBridgeHeader)) {
+            header = (ShmBridgeHeader*)region.Data();
+            if (header->ready.load(std::memory_order_acquire) && memcmp(header->magic, "ROVSHM01", 8) == 0 &&
+                header->version == 1 && region.Size() >= RegionSize(header->ringSize))
+                break;
+            header = nullptr;
+            region.Close();
+        }
+        if (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > timeout) {
+            std::cerr << "No simulator bridge " << name << " within " << timeout << " s" << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    uint32_t ringSize = header->ringSize;
+    states = ShmRing<BridgeState>(&header->states, (BridgeState*)(region.Data() + StatesOffset()), ringSize);
+    commands =
+        ShmRing<BridgeCommand>(&header->commands, (BridgeCommand*)(region.Data() + CommandsOffset(ringSize)), ringSize);
+    header->clientAttached.store(1, std::memory_order_release);
+    return true;
+}
+
+ShmBridgeClient::~ShmBridgeClient() {
+    if (header)
+        header->clientAttached.store(0, std::memory_order_release);
+}
+
+bool ShmBridgeClient::Poll(BridgeState& state) {
+    bool any = false;
+    while (states.Pop(state))
+        any = true;
+    return any;
+}
+
+bool ShmBridgeClient::Send(const BridgeCommand& command) {
+    return commands.Push(command);
+}
+
+bool ShmBridgeClient::SimulatorRunning() const {
+    return header && header->ready.load(std::memory_order_acquire);
+}
@@ -0,0 +1,205 @@
+// =============================================================================
+// Shared-memory bridge to an external autonomy process.
+//
+// The simulator creates a named shared memory region (POSIX shm_open, a
+// pagefile-backed named mapping on Windows) holding a small header and two
+// single producer / single consumer rings: BridgeStates out (simulator ->
+// client) and BridgeCommands in (client -> simulator). Records are plain
+// fixed-size data written in place, so nothing is serialized or copied
+// through the kernel, and neither side ever takes a lock.
+//
+// Every published state carries the physics step count as its sequence
+// number; a command names the sequence of the state it answers. Free running,
+// the simulator applies the newest command before each step and never
+// waits; a full state ring drops the state and counts it. In lockstep the
+// simulator waits after publishing state N until the command answering N
+// has arrived (or timeout passes, counted), so the client sees every step.
+//
+// Call BeforeStep before every DoStepDynamics and AfterStep after it.
+// ShmBridgeClient is the other end, for the autonomy process.
+// =============================================================================
+
+#ifndef SHM_BRIDGE_H
+#define SHM_BRIDGE_H
+
+#include "chrono/physics/ChSystem.h"
+
+#include "rover_controller.h"
+#include "streaming_stats.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "the shared memory rings need lock-free 64 bit atomics");
+
+//simulator -> client, after every step
+struct BridgeState {
+    uint64_t sequence;          //physics steps taken
+    double time;                //sim time
+    double position[3];         //chassis, absolute
+    double rotation[4];         //chassis quaternion e0..e3
+    double velocity[3];         //chassis, absolute
+    double angularRate[3];      //chassis frame (gyro)
+    double specificForce[3];    //chassis frame (accelerometer)
+    int32_t numWheels;
+    int32_t numLeftWheels;
+    double wheelSpeed[RoverState::maxWheels];   //rad/s
+    double wheelTorque[RoverState::maxWheels];  //applied during the step that ended here, N*m
+};
+
+//client -> simulator
+struct BridgeCommand {
+    uint64_t sequence;  //the state this answers
+    double torque[RoverState::maxWheels];
+};
+
+//head and tail of one ring, on their own cache lines
+struct ShmRingIndices {
+    alignas(64) std::atomic<uint64_t> head;  //next slot to write, owned by the producer
+    alignas(64) std::atomic<uint64_t> tail;  //next slot to read, owned by the consumer
+};
+
+//start of the shared region. The rings' slots follow it.
+struct ShmBridgeHeader {
+    char magic[8];  //"ROVSHM01"
+    uint32_t version;
+    uint32_t ringSize;   //slots per ring, a power of two
+    uint32_t lockstep;
+    std::atomic<uint32_t> ready;           //set by the simulator once initialized, cleared when it exits
+    std::atomic<uint32_t> clientAttached;
+    ShmRingIndices states;
+    ShmRingIndices commands;
+};
+
+//SPSC ring over memory it does not own -> works between processes
+template <typename T>
+class ShmRing {
+  public:
+    ShmRing() {}
+    ShmRing(ShmRingIndices* indices, T* slots, uint32_t capacity) : indices(indices), slots(slots), mask(capacity - 1) {}
+
+    bool Push(const T& item) {
+        uint64_t h = indices->head.load(std::memory_order_relaxed);
+        if (h - indices->tail.load(std::memory_order_acquire) > mask)
+            return false;
+        slots[h & mask] = item;
+        indices->head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(T& item) {
+        uint64_t t = indices->tail.load(std::memory_order_relaxed);
+        if (t == indices->head.load(std::memory_order_acquire))
+            return false;
+        item = slots[t & mask];
+        indices->tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+  private:
+    ShmRingIndices* indices = nullptr;
+    T* slots = nullptr;
+    uint64_t mask = 0;
+};
+
+//named shared memory region, created or opened
+class SharedRegion {
+  public:
+    SharedRegion() {}
+    ~SharedRegion();
+
+    bool Create(const std::string& name, size_t size);
+    bool Open(const std::string& name);
+    void Close();
+
+    char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+  private:
+    SharedRegion(const SharedRegion&);
+    SharedRegion& operator=(const SharedRegion&);
+
+    std::string name;
+    bool owner = false;
+    char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* mapping = nullptr;
+#endif
+};
+
+struct ShmBridgeSettings {
+    uint32_t ringSize = 64;       //rounded up to a power of two
+    bool lockstep = false;
+    double timeout = 1.0;         //s to wait for each answer in lockstep
+    double attachTimeout = 30.0;  //s to wait for the client before the first lockstep step
+};
+
+class ShmBridge {
+  public:
+    //create the region. Prints what is wrong.
+    bool Create(const std::string& name, const ShmBridgeSettings& settings = ShmBridgeSettings());
+    ~ShmBridge();
+
+    //apply the newest command, waiting for the answer to the last state in lockstep. The first call
+    //publishes the initial state. Returns false if lockstep could not start because no client attached.
+    bool BeforeStep(RoverModel& rover, const chrono::ChSystem& system);
+    //publish the state after the step
+    void AfterStep(const RoverModel& rover, const chrono::ChSystem& system);
+
+    void PrintSummary(std::ostream& out) const;
+
+  private:
+    bool TakeCommands();
+    void Publish(const RoverModel& rover, const chrono::ChSystem& system);
+
+    SharedRegion region;
+    ShmBridgeHeader* header = nullptr;
+    ShmRing<BridgeState> states;
+    ShmRing<BridgeCommand> commands;
+    ShmBridgeSettings settings;
+    std::string name;
+
+    bool started = false;
+    uint64_t sequence = 0;          //of the last published state
+    BridgeCommand command = {};     //newest command received
+    bool haveCommand = false;
+    RoverState roverState;
+    RoverCommand roverCommand;
+    BridgeState state = {};
+
+    long published = 0;
+    long dropped = 0;
+    long commandsReceived = 0;
+    long staleCommands = 0;     //answers to an older state than the last published one
+    long timeouts = 0;
+    RunningStats answerWait;    //lockstep, s
+    RunningStats publishTime;   //state read and push, s
+};
+
+//client side, for the autonomy process
+class ShmBridgeClient {
+  public:
+    //open the simulator's region, waiting up to timeout seconds for it to appear
+    bool Attach(const std::string& name, double timeout = 10.0);
+    ~ShmBridgeClient();
+
+    //newest published state, skipping older ones. False if none arrived since the last call.
+    bool Poll(BridgeState& state);
+    //false if the command ring is full
+    bool Send(const BridgeCommand& command);
+    //false once the simulator has exited
+    bool SimulatorRunning() const;
+    bool Lockstep() const { return header && header->lockstep; }
+
+  private:
+    SharedRegion region;
+    ShmBridgeHeader* header = nullptr;
+    ShmRing<BridgeState> states;
+    ShmRing<BridgeCommand> commands;
+};
+
+#endif
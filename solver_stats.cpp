@@ -0,0 +1,88 @@
+#include "solver_stats.h"
+
+#include <algorithm>
+
+using namespace chrono;
+
+template <typename T>
+static SolverStatSummary Summarize(const std::vector<T>& samples) {
+    SolverStatSummary summary;
+    if (samples.empty())
+        return summary;
+
+    std::vector<T> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0;
+    for (T sample : sorted)
+        sum += sample;
+    summary.mean = sum / sorted.size();
+    size_t rank = (size_t)(.99 * sorted.size() + 0.999999);  //nearest rank
+    summary.p99 = (double)sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+    summary.max = (double)sorted.back();
+    return summary;
+}
+
+static SolverStatSummary Summarize(const RunningStats& stats, const P2Quantile& p99) {
+    SolverStatSummary summary;
+    summary.mean = stats.Mean();
+    summary.p99 = p99.Value();
+    summary.max = stats.Max();
+    return summary;
+}
+
+SolverStats::SolverStats(ChSystem& system, double tolerance, bool record, bool keepHistory)
+    : tolerance(tolerance), keepHistory(keepHistory) {
+    auto iterative = std::dynamic_pointer_cast<ChIterativeSolver>(system.GetSolver());
+    if (!iterative)
+        return;
+
+    if (tolerance > 0) {
+        system.SetTolForce(tolerance);
+        iterative->SetTolerance(tolerance);
+    }
+    if (!record)
+        return;
+    //one violation entry per iteration -> history length is the iteration count
+    solver = iterative;
+    solver->SetRecordViolation(true);
+}
+
+void SolverStats::Record() {
+    if (!solver)
+        return;
+    const std::vector<double>& history = solver->GetViolationHistory();
+    lastIterations = (int)history.size();
+    lastResidual = history.empty() ? 0 : history.back();
+    iterationStats.Add(lastIterations);
+    iterationP99.Add(lastIterations);
+    residualStats.Add(lastResidual);
+    residualP99.Add(lastResidual);
+    if (keepHistory) {
+        iterations.push_back(lastIterations);
+        residuals.push_back(lastResidual);
+    }
+}
+
+//exact from the history when there is one
+SolverStatSummary SolverStats::IterationSummary() const {
+    return keepHistory ? Summarize(iterations) : Summarize(iterationStats, iterationP99);
+}
+
+SolverStatSummary SolverStats::ResidualSummary() const {
+    return keepHistory ? Summarize(residuals) : Summarize(residualStats, residualP99);
+}
+
+void SolverStats::PrintSummary(std::ostream& out) const {
+    if (!solver) {
+        out << "SOLVER STATS: not recording or not an iterative solver, nothing recorded" << std::endl;
+        return;
+    }
+    SolverStatSummary iters = IterationSummary();
+    SolverStatSummary residual = ResidualSummary();
+    out << "SOLVER STATS: " << NumSteps() << " steps";
+    if (tolerance > 0)
+        out << ", tolerance " << tolerance;
+    out << std::endl;
+    out << "SOLVER ITERATIONS: mean " << iters.mean << " p99 " << iters.p99 << " max " << iters.max << std::endl;
+    out << "SOLVER RESIDUAL: mean " << residual.mean << " p99 " << residual.p99 << " max " << residual.max << std::endl;
+}
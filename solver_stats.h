@@ -0,0 +1,72 @@
+// =============================================================================
+// Per-step iteration count and residual of the iterative speed solver.
+//
+// With a tolerance the solver stops as soon as the constraint residual drops
+// below it; SetMaxItersSolverSpeed is then only the cap for hard steps. The
+// recorded iterations show how large that cap really needs to be.
+//
+// Recording makes Chrono keep the residual of every solver iteration, so it
+// is optional. Mean/p99/max are streamed (see streaming_stats.h) in constant
+// memory; with keepHistory every step is stored as well, growing with the
+// run, and the summaries are exact.
+// =============================================================================
+
+#ifndef SOLVER_STATS_H
+#define SOLVER_STATS_H
+
+#include "chrono/physics/ChSystem.h"
+#include "chrono/solver/ChIterativeSolver.h"
+
+#include "streaming_stats.h"
+
+#include <memory>
+#include <ostream>
+#include <vector>
+
+struct SolverStatSummary {
+    double mean = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+class SolverStats {
+  public:
+    //tolerance > 0 -> convergence based termination of the speed solver. record = false only
+    //applies the tolerance. keepHistory stores every step, not only the statistics.
+    explicit SolverStats(chrono::ChSystem& system, double tolerance = 0, bool record = true,
+                         bool keepHistory = false);
+
+    //false if not recording or the system does not use an iterative solver (nothing is recorded)
+    bool IsRecording() const { return solver != nullptr; }
+
+    //call after every DoStepDynamics -> adds the iterations and final residual of that step
+    void Record();
+
+    size_t NumSteps() const { return iterationStats.Count(); }
+    //empty unless keepHistory
+    const std::vector<int>& Iterations() const { return iterations; }
+    const std::vector<double>& Residuals() const { return residuals; }
+    int LastIterations() const { return lastIterations; }
+    double LastResidual() const { return lastResidual; }
+
+    SolverStatSummary IterationSummary() const;
+    SolverStatSummary ResidualSummary() const;
+
+    //mean/p99/max of iterations and residuals
+    void PrintSummary(std::ostream& out) const;
+
+  private:
+    std::shared_ptr<chrono::ChIterativeSolver> solver;
+    double tolerance;
+    bool keepHistory;
+    std::vector<int> iterations;
+    std::vector<double> residuals;
+    int lastIterations = 0;
+    double lastResidual = 0;
+    RunningStats iterationStats;
+    RunningStats residualStats;
+    P2Quantile iterationP99{.99};
+    P2Quantile residualP99{.99};
+};
+
+#endif
@@ -0,0 +1,88 @@
+#include "spring_telemetry.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace chrono;
+
+SpringTelemetry::SpringTelemetry(const std::vector<std::shared_ptr<ChLinkSpring>>& springs,
+                                 const SpringTelemetrySettings& settings)
+    : springs(springs), settings(settings), lastPower(springs.size(), 0.0), summaries(springs.size()) {}
+
+void SpringTelemetry::Reserve(size_t numSteps) {
+    if (!settings.keepHistory)
+        return;
+    times.reserve(numSteps);
+    length.reserve(numSteps * springs.size());
+    deflection.reserve(numSteps * springs.size());
+    force.reserve(numSteps * springs.size());
+    dampedEnergy.reserve(numSteps * springs.size());
+}
+
+void SpringTelemetry::Record(double time) {
+    double dt = numSteps > 0 ? time - lastTime : 0;
+    for (size_t s = 0; s < springs.size(); s++) {
+        ChLinkSpring& spring = *springs[s];
+        double l = spring.Get_SpringLength();
+        double d = spring.Get_SpringDeform();
+        double f = spring.Get_SpringReact();
+        double v = spring.Get_SpringVelocity();
+        double power = spring.Get_SpringR() * v * v;
+
+        SpringSummary& summary = summaries[s];
+        summary.length.Add(l);
+        summary.deflection.Add(d);
+        summary.force.Add(f);
+        summary.dampedEnergy += 0.5 * (lastPower[s] + power) * dt;
+        lastPower[s] = power;
+
+        if (settings.keepHistory) {
+            length.push_back((float)l);
+            deflection.push_back((float)d);
+            force.push_back((float)f);
+            dampedEnergy.push_back((float)summary.dampedEnergy);
+        }
+    }
+    if (settings.keepHistory)
+        times.push_back(time);
+    lastTime = time;
+    numSteps++;
+}
+
+double SpringTelemetry::PeakForce() const {
+    double peak = 0;
+    for (const SpringSummary& summary : summaries)
+        peak = std::max(peak, std::max(std::abs(summary.force.Min()), std::abs(summary.force.Max())));
+    return peak;
+}
+
+void SpringTelemetry::WriteCsv(std::ostream& out) const {
+    size_t n = springs.size();
+    out << "time";
+    for (size_t s = 0; s < n; s++)
+        out << ",length_" << s << ",deflection_" << s << ",force_" << s << ",damper_energy_" << s;
+    out << "\n";
+    for (size_t t = 0; t < times.size(); t++) {
+        out << times[t];
+        for (size_t s = 0; s < n; s++) {
+            size_t i = t * n + s;
+            out << ',' << length[i] << ',' << deflection[i] << ',' << force[i] << ',' << dampedEnergy[i];
+        }
+        out << "\n";
+    }
+}
+
+void SpringTelemetry::PrintSummary(std::ostream& out) const {
+    out << "SPRINGS: " << springs.size() << " springs, " << numSteps << " steps (min / max / rms)" << std::endl;
+    double energy = 0;
+    for (size_t s = 0; s < springs.size(); s++) {
+        const SpringSummary& summary = summaries[s];
+        out << "SPRING " << s << ": length " << summary.length.Min() << " / " << summary.length.Max()
+            << " m, deflection " << summary.deflection.Min() << " / " << summary.deflection.Max() << " / "
+            << summary.deflection.Rms() << " m, force " << summary.force.Min() << " / " << summary.force.Max()
+            << " / " << summary.force.Rms() << " N, damper " << summary.dampedEnergy << " J" << std::endl;
+        energy += summary.dampedEnergy;
+    }
+    out << "SPRING PEAK FORCE: " << PeakForce() << " N" << std::endl;
+    out << "DAMPER ENERGY: " << energy << " J" << std::endl;
+}
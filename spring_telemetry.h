@@ -0,0 +1,83 @@
+// =============================================================================
+// Suspension spring telemetry.
+//
+// Samples every ChLinkSpring of a rover after each step: length,
+// deflection from rest length, force (spring plus damper, as Chrono reports
+// it) and the energy the damper has dissipated so far, integrated from its
+// power R * v^2 with the trapezoidal rule over the sampled steps. With
+// keepHistory every sample goes into preallocated columnar buffers, one
+// entry per spring per step. Running min/max/RMS of length, deflection and
+// force are kept either way (see streaming_stats.h), so long runs can report
+// peak spring loads without storing the history.
+// =============================================================================
+
+#ifndef SPRING_TELEMETRY_H
+#define SPRING_TELEMETRY_H
+
+#include "chrono/physics/ChLinkSpring.h"
+
+#include "streaming_stats.h"
+
+#include <memory>
+#include <ostream>
+#include <vector>
+
+struct SpringTelemetrySettings {
+    bool keepHistory = true;  //store every step, not only the statistics
+};
+
+//running statistics of one spring
+struct SpringSummary {
+    RunningStats length;      //m
+    RunningStats deflection;  //m, > 0 stretched
+    RunningStats force;       //N
+    double dampedEnergy = 0;  //J dissipated by the damper
+};
+
+class SpringTelemetry {
+  public:
+    SpringTelemetry(const std::vector<std::shared_ptr<chrono::ChLinkSpring>>& springs,
+                    const SpringTelemetrySettings& settings = SpringTelemetrySettings());
+
+    //preallocate the history for the expected number of steps
+    void Reserve(size_t numSteps);
+
+    //call after every DoStepDynamics with the sim time reached
+    void Record(double time);
+
+    size_t NumSprings() const { return springs.size(); }
+    size_t NumSteps() const { return numSteps; }
+
+    //history (keepHistory only): NumSprings() entries per step, step after step
+    const std::vector<double>& Times() const { return times; }
+    const std::vector<float>& Length() const { return length; }
+    const std::vector<float>& Deflection() const { return deflection; }
+    const std::vector<float>& Force() const { return force; }
+    const std::vector<float>& DampedEnergy() const { return dampedEnergy; }
+
+    const SpringSummary& Summary(size_t spring) const { return summaries[spring]; }
+    //largest |force| of any spring so far
+    double PeakForce() const;
+
+    //time, then length, deflection, force and damper energy of every spring per row (keepHistory only)
+    void WriteCsv(std::ostream& out) const;
+
+    void PrintSummary(std::ostream& out) const;
+
+  private:
+    std::vector<std::shared_ptr<chrono::ChLinkSpring>> springs;
+    SpringTelemetrySettings settings;
+
+    std::vector<double> times;
+    std::vector<float> length;
+    std::vector<float> deflection;
+    std::vector<float> force;
+    std::vector<float> dampedEnergy;
+    size_t numSteps = 0;
+
+    double lastTime = 0;
+    std::vector<double> lastPower;  //damper power at the last sample, W
+    std::vector<SpringSummary> summaries;
+};
+
+#endif
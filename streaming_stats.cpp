@@ -0,0 +1,112 @@
+#include "streaming_stats.h"
+
+#include <algorithm>
+#include <math.h>
+
+void RunningStats::Add(double x) {
+    if (count == 0) {
+        min = max = x;
+    } else {
+        min = std::min(min, x);
+        max = std::max(max, x);
+    }
+    count++;
+    double delta = x - mean;
+    mean += delta / count;
+    m2 += delta * (x - mean);
+    sumSquares += x * x;
+}
+
+double RunningStats::StdDev() const {
+    return sqrt(Variance());
+}
+
+double RunningStats::Rms() const {
+    return count > 0 ? sqrt(sumSquares / count) : 0;
+}
+
+P2Quantile::P2Quantile(double p) : p(p) {
+    for (int i = 0; i < 5; i++)
+        heights[i] = positions[i] = desired[i] = increments[i] = 0;
+}
+
+void P2Quantile::Add(double x) {
+    //the first five samples become the markers
+    if (count < 5) {
+        heights[count++] = x;
+        if (count == 5) {
+            std::sort(heights, heights + 5);
+            for (int i = 0; i < 5; i++)
+                positions[i] = i + 1;
+            desired[0] = 1;
+            desired[1] = 1 + 2 * p;
+            desired[2] = 1 + 4 * p;
+            desired[3] = 3 + 2 * p;
+            desired[4] = 5;
+            increments[0] = 0;
+            increments[1] = p / 2;
+            increments[2] = p;
+            increments[3] = (1 + p) / 2;
+            increments[4] = 1;
+        }
+        return;
+    }
+    count++;
+
+    //cell k with heights[k] <= x < heights[k + 1], stretching the end markers if needed
+    int k = 0;
+    if (x < heights[0]) {
+        heights[0] = x;
+    } else if (x >= heights[4]) {
+        heights[4] = x;
+        k = 3;
+    } else {
+        while (x >= heights[k + 1])
+            k++;
+    }
+    for (int i = k + 1; i < 5; i++)
+        positions[i]++;
+    for (int i = 0; i < 5; i++)
+        desired[i] += increments[i];
+
+    //move the middle markers that are a rank or more off, piecewise parabolic where it stays ordered
+    for (int i = 1; i < 4; i++) {
+        double offset = desired[i] - positions[i];
+        if ((offset >= 1 && positions[i + 1] - positions[i] > 1) || (offset <= -1 && positions[i - 1] - positions[i] < -1)) {
+            int s = offset > 0 ? 1 : -1;
+            double parabolic = heights[i] + s / (positions[i + 1] - positions[i - 1]) *
+                ((positions[i] - positions[i - 1] + s) * (heights[i + 1] - heights[i]) / (positions[i + 1] - positions[i]) +
+                 (positions[i + 1] - positions[i] - s) * (heights[i] - heights[i - 1]) / (positions[i] - positions[i - 1]));
+            if (heights[i - 1] < parabolic && parabolic < heights[i + 1])
+                heights[i] = parabolic;
+            else
+                heights[i] += s * (heights[i + s] - heights[i]) / (positions[i + s] - positions[i]);
+            positions[i] += s;
+        }
+    }
+}
+
+double P2Quantile::Value() const {
+    if (count == 0)
+        return 0;
+    if (count >= 5)
+        return heights[2];
+    //nearest rank of the few samples so far
+    double sorted[5];
+    std::copy(heights, heights + count, sorted);
+    std::sort(sorted, sorted + count);
+    size_t rank = (size_t)ceil(p * count);
+    return sorted[std::min(count, std::max<size_t>(rank, 1)) - 1];
+}
+
+void StreamingSummary::Add(double x) {
+    stats.Add(x);
+    p05.Add(x);
+    p50.Add(x);
+    p95.Add(x);
+}
+
+void StreamingSummary::Print(std::ostream& out) const {
+    out << "mean " << stats.Mean() << " sd " << stats.StdDev() << " min " << stats.Min() << " p05 " << P05() << " p50 "
+        << P50() << " p95 " << P95() << " max " << stats.Max();
+}
@@ -0,0 +1,78 @@
+// =============================================================================
+// Constant memory statistics of a stream of samples.
+//
+// RunningStats keeps count, mean and variance (Welford's update), min, max
+// and RMS. P2Quantile estimates one quantile with the P-square algorithm of
+// Jain and Chlamtac: five markers whose heights follow the quantile as
+// samples arrive, so no sample is stored. Exact for up to five samples,
+// within a fraction of the spread of the data after that.
+// =============================================================================
+
+#ifndef STREAMING_STATS_H
+#define STREAMING_STATS_H
+
+#include <cstddef>
+#include <ostream>
+
+class RunningStats {
+  public:
+    void Add(double x);
+
+    size_t Count() const { return count; }
+    double Mean() const { return mean; }
+    double Variance() const { return count > 1 ? m2 / (count - 1) : 0; }
+    double StdDev() const;
+    double Min() const { return min; }
+    double Max() const { return max; }
+    double Rms() const;
+
+  private:
+    size_t count = 0;
+    double mean = 0;
+    double m2 = 0;  //sum of squared deviations from the mean
+    double min = 0;
+    double max = 0;
+    double sumSquares = 0;
+};
+
+class P2Quantile {
+  public:
+    //p in (0, 1), e.g. .5 for the median
+    explicit P2Quantile(double p);
+
+    void Add(double x);
+
+    size_t Count() const { return count; }
+    //0 before the first sample
+    double Value() const;
+
+  private:
+    double p;
+    size_t count = 0;
+    double heights[5];    //marker heights -> min, p/2, p, (1 + p)/2 quantiles and max
+    double positions[5];  //actual marker positions (1-based ranks)
+    double desired[5];    //desired marker positions
+    double increments[5]; //desired position increments per sample
+};
+
+//RunningStats and the 5%, 50% and 95% quantiles of one metric
+class StreamingSummary {
+  public:
+    StreamingSummary() : p05(.05), p50(.5), p95(.95) {}
+
+    void Add(double x);
+
+    const RunningStats& Stats() const { return stats; }
+    double P05() const { return p05.Value(); }
+    double P50() const { return p50.Value(); }
+    double P95() const { return p95.Value(); }
+
+    //"mean m sd s min a p05 b p50 c p95 d max e"
+    void Print(std::ostream& out) const;
+
+  private:
+    RunningStats stats;
+    P2Quantile p05, p50, p95;
+};
+
+#endif
@@ -0,0 +1,123 @@
+#include "sweep_spec.h"
+#include "rover_run.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static std::string Trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos)
+        return "";
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+static std::vector<std::string> Split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, separator))
+        parts.push_back(Trim(part));
+    return parts;
+}
+
+//"a, b, c" or "start:stop:increment"
+static std::vector<double> ParseValues(const std::string& text) {
+    std::vector<double> values;
+    if (text.find(':') != std::string::npos) {
+        std::vector<std::string> range = Split(text, ':');
+        if (range.size() == 3 && atof(range[2].c_str()) > 0) {
+            double start = atof(range[0].c_str());
+            double stop = atof(range[1].c_str());
+            double increment = atof(range[2].c_str());
+            for (int i = 0; start + i * increment <= stop + 1e-9 * increment; i++)
+                values.push_back(start + i * increment);
+        }
+        return values;
+    }
+    for (const auto& value : Split(text, ','))
+        if (!value.empty())
+            values.push_back(atof(value.c_str()));
+    return values;
+}
+
+bool ReadSweepSpec(const std::string& path, SweepSpec& spec) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Could not open sweep file " << path << std::endl;
+        return false;
+    }
+
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)) {
+        line = Trim(line);
+        if (!line.empty() && line[0] != '#')
+            lines.push_back(line);
+    }
+    if (lines.empty()) {
+        std::cerr << "Sweep file " << path << " is empty" << std::endl;
+        return false;
+    }
+
+    if (lines[0].find('=') != std::string::npos) {
+        //grid -> cartesian product of every axis
+        std::vector<std::vector<double>> axes;
+        for (const auto& gridLine : lines) {
+            size_t eq = gridLine.find('=');
+            if (eq == std::string::npos) {
+                std::cerr << "Expected \"name = values\": " << gridLine << std::endl;
+                return false;
+            }
+            spec.names.push_back(Trim(gridLine.substr(0, eq)));
+            axes.push_back(ParseValues(gridLine.substr(eq + 1)));
+            if (axes.back().empty()) {
+                std::cerr << "No values for " << spec.names.back() << std::endl;
+                return false;
+            }
+        }
+
+        std::vector<size_t> index(axes.size(), 0);
+        while (true) {
+            std::vector<double> run;
+            for (size_t a = 0; a < axes.size(); a++)
+                run.push_back(axes[a][index[a]]);
+            spec.runs.push_back(run);
+
+            size_t a = 0;
+            while (a < axes.size() && ++index[a] == axes[a].size())
+                index[a++] = 0;
+            if (a == axes.size())
+                break;
+        }
+    } else {
+        //list -> CSV header then one row per run
+        spec.names = Split(lines[0], ',');
+        for (size_t l = 1; l < lines.size(); l++) {
+            std::vector<double> run = ParseValues(lines[l]);
+            if (run.size() != spec.names.size()) {
+                std::cerr << "Row " << l << " has " << run.size() << " values, expected " << spec.names.size() << std::endl;
+                return false;
+            }
+            spec.runs.push_back(run);
+        }
+    }
+
+    RoverDParameters check;
+    for (const auto& name : spec.names) {
+        if (!SetRoverDParameter(check, name, 0)) {
+            std::cerr << "Unknown parameter " << name << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+RoverDParameters SweepSpec::Parameters(size_t r) const {
+    RoverDParameters params;
+    for (size_t n = 0; n < names.size(); n++)
+        SetRoverDParameter(params, names[n], runs[r][n]);
+    return params;
+}
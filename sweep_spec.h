@@ -0,0 +1,38 @@
+// =============================================================================
+// Sweep files shared by the roverD batch tools (roverD_sweep, roverD_screen).
+//
+// A sweep file is either a grid or a list of parameter sets:
+//
+//   grid -> one "name = values" line per swept parameter, every combination is run
+//       k = 5000, 10000, 20000
+//       tibiaAngle = 20:40:5        (start:stop:increment)
+//
+//   list -> a CSV header of parameter names followed by one row per run
+//       k,c,restLength
+//       10000,1000,.22
+//       20000,500,.20
+//
+// Names are the RoverDParameters fields (see SetRoverDParameter in
+// rover_run.h); angles are in degrees. Lines starting with # are ignored.
+// =============================================================================
+
+#ifndef SWEEP_SPEC_H
+#define SWEEP_SPEC_H
+
+#include "rover_model.h"
+
+#include <string>
+#include <vector>
+
+struct SweepSpec {
+    std::vector<std::string> names;
+    std::vector<std::vector<double>> runs;  //one value per name for every run
+
+    //defaults with the values of run r applied
+    RoverDParameters Parameters(size_t r) const;
+};
+
+//print what is wrong and return false for unreadable files and unknown parameter names
+bool ReadSweepSpec(const std::string& path, SweepSpec& spec);
+
+#endif
@@ -0,0 +1,125 @@
+#include "telemetry.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace chrono;
+
+TelemetryWriter::TelemetryWriter(const std::string& csvPath, double statusPeriod)
+    : statusPeriod(statusPeriod), headerWritten(false), running(true), dropped(0) {
+    if (!csvPath.empty()) {
+        csv.open(csvPath);
+        if (!csv)
+            std::cerr << "Telemetry: could not open " << csvPath << std::endl;
+    }
+    writer = std::thread(&TelemetryWriter::WriterLoop, this);
+}
+
+TelemetryWriter::~TelemetryWriter() {
+    Stop();
+}
+
+void TelemetryWriter::SetSources(std::shared_ptr<ChBody> chassis,
+                                 const std::vector<std::shared_ptr<ChLinkLock>>& wheelJoints) {
+    this->chassis = chassis;
+    this->wheelJoints = wheelJoints;
+    if (this->wheelJoints.size() > TelemetryRecord::maxWheels)
+        this->wheelJoints.resize(TelemetryRecord::maxWheels);
+}
+
+void TelemetryWriter::Record(long step, double time) {
+    TelemetryRecord record;
+    record.step = step;
+    record.time = time;
+
+    if (chassis) {
+        const ChVector<>& pos = chassis->GetPos();
+        const ChQuaternion<>& rot = chassis->GetRot();
+        record.pos[0] = pos.x();
+        record.pos[1] = pos.y();
+        record.pos[2] = pos.z();
+        record.rot[0] = rot.e0();
+        record.rot[1] = rot.e1();
+        record.rot[2] = rot.e2();
+        record.rot[3] = rot.e3();
+    } else {
+        record.pos[0] = record.pos[1] = record.pos[2] = 0;
+        record.rot[0] = 1;
+        record.rot[1] = record.rot[2] = record.rot[3] = 0;
+    }
+
+    //revolute joints rotate about the z axis of their link frame
+    record.numWheels = (int)wheelJoints.size();
+    for (int i = 0; i < record.numWheels; i++)
+        record.wheelSpeed[i] = wheelJoints[i]->GetRelWvel().z();
+
+    if (!ring.Push(record))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TelemetryWriter::Stop() {
+    if (!writer.joinable())
+        return;
+    running.store(false, std::memory_order_release);
+    writer.join();
+    if (csv.is_open())
+        csv.close();
+    if (GetDropped() > 0)
+        std::cout << "Telemetry: dropped " << GetDropped() << " records" << std::endl;
+}
+
+void TelemetryWriter::Write(const TelemetryRecord& record) {
+    if (!csv.is_open())
+        return;
+    if (!headerWritten) {
+        csv << "step,time,x,y,z,e0,e1,e2,e3";
+        for (int i = 0; i < record.numWheels; i++)
+            csv << ",wheel_" << i;
+        csv << '\n';
+        headerWritten = true;
+    }
+    csv << record.step << ',' << record.time;
+    for (int i = 0; i < 3; i++)
+        csv << ',' << record.pos[i];
+    for (int i = 0; i < 4; i++)
+        csv << ',' << record.rot[i];
+    for (int i = 0; i < record.numWheels; i++)
+        csv << ',' << record.wheelSpeed[i];
+    csv << '\n';
+}
+
+void TelemetryWriter::WriterLoop() {
+    auto nextStatus = std::chrono::steady_clock::now();
+    TelemetryRecord record;
+    TelemetryRecord latest;
+    bool haveLatest = false;
+
+    while (true) {
+        //read the flag before draining so records pushed before Stop() are never lost
+        bool stopping = !running.load(std::memory_order_acquire);
+
+        int drained = 0;
+        while (ring.Pop(record)) {
+            Write(record);
+            latest = record;
+            haveLatest = true;
+            drained++;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (haveLatest && (now >= nextStatus || stopping)) {
+            std::cout << "Step number: " << latest.step << "  t = " << latest.time << " s  chassis = ("
+                      << latest.pos[0] << ", " << latest.pos[1] << ", " << latest.pos[2] << ")" << std::endl;
+            nextStatus = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                   std::chrono::duration<double>(statusPeriod));
+        }
+
+        if (stopping)
+            break;
+        if (drained == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    if (csv.is_open())
+        csv.flush();
+}
@@ -0,0 +1,108 @@
+// =============================================================================
+// Asynchronous step telemetry.
+//
+// The step loop pushes fixed-size TelemetryRecords into a lock-free single
+// producer / single consumer ring buffer. A background writer thread drains
+// the buffer, appends the records to a CSV file (optional) and prints a
+// status line every statusPeriod seconds of wall time. Pushing never blocks:
+// if the writer falls behind, records are dropped and counted.
+// =============================================================================
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "chrono/physics/ChBody.h"
+#include "chrono/physics/ChLinkLock.h"
+
+#include <atomic>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+//one record per physics step -> plain data, copied by value into the ring
+struct TelemetryRecord {
+    static const int maxWheels = 8;
+
+    long step;
+    double time;
+    double pos[3];  //chassis position
+    double rot[4];  //chassis orientation quaternion (e0, e1, e2, e3)
+    int numWheels;
+    double wheelSpeed[maxWheels];  //wheel angular speed relative to its joint, rad/s
+};
+
+//lock-free ring buffer for exactly one producer thread and one consumer thread.
+//Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+  public:
+    SpscRing() : buffer(new T[Capacity]), head(0), tail(0) {}
+
+    //producer side. Returns false (and leaves the ring untouched) when full.
+    bool Push(const T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == Capacity)
+            return false;
+        buffer[h & (Capacity - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    //consumer side. Returns false when empty.
+    bool Pop(T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return false;
+        item = buffer[t & (Capacity - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+  private:
+    std::unique_ptr<T[]> buffer;
+    alignas(64) std::atomic<size_t> head;  //next slot to write, owned by the producer
+    alignas(64) std::atomic<size_t> tail;  //next slot to read, owned by the consumer
+};
+
+class TelemetryWriter {
+  public:
+    static const size_t ringSize = 1 << 14;
+
+    //csvPath may be empty to only print status lines
+    TelemetryWriter(const std::string& csvPath, double statusPeriod = 1.0);
+    ~TelemetryWriter();
+
+    //record the chassis pose and the speed of each wheel joint for this step
+    void SetSources(std::shared_ptr<chrono::ChBody> chassis,
+                    const std::vector<std::shared_ptr<chrono::ChLinkLock>>& wheelJoints);
+
+    //called from the step loop -> copies a few doubles into the ring, never blocks
+    void Record(long step, double time);
+
+    //drain what is left in the ring and join the writer thread
+    void Stop();
+
+    long GetDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+  private:
+    void WriterLoop();
+    void Write(const TelemetryRecord& record);
+
+    SpscRing<TelemetryRecord, ringSize> ring;
+    std::shared_ptr<chrono::ChBody> chassis;
+    std::vector<std::shared_ptr<chrono::ChLinkLock>> wheelJoints;
+
+    std::ofstream csv;
+    double statusPeriod;
+    bool headerWritten;
+    std::atomic<bool> running;
+    std::atomic<long> dropped;
+    std::thread writer;
+};
+
+#endif
@@ -0,0 +1,217 @@
+#include "terrain.h"
+
+#include "chrono/assets/ChTriangleMeshShape.h"
+#include "chrono/assets/ChColorAsset.h"
+#include "chrono/geometry/ChTriangleMeshConnected.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <math.h>
+#include <vector>
+
+using namespace chrono;
+
+// -----------------------------------------------------------------------------
+// HeightRaster
+// -----------------------------------------------------------------------------
+
+//next header token of a PGM file, skipping whitespace and comments
+static bool NextToken(const char*& pos, const char* end, long& value) {
+    while (pos < end) {
+        if (*pos == '#') {
+            while (pos < end && *pos != '\n')
+                pos++;
+        } else if (isspace((unsigned char)*pos)) {
+            pos++;
+        } else {
+            break;
+        }
+    }
+    if (pos >= end || !isdigit((unsigned char)*pos))
+        return false;
+    value = 0;
+    while (pos < end && isdigit((unsigned char)*pos))
+        value = value * 10 + (*pos++ - '0');
+    return true;
+}
+
+bool HeightRaster::Open(const std::string& path) {
+    if (!file.OpenRead(path)) {
+        std::cerr << "Could not open height raster " << path << std::endl;
+        return false;
+    }
+
+    const char* pos = file.Data();
+    const char* end = pos + file.Size();
+    long width = 0, height = 0, maxValue = 0;
+    bool valid = file.Size() > 2 && pos[0] == 'P' && pos[1] == '5';
+    pos += 2;
+    valid = valid && NextToken(pos, end, width) && NextToken(pos, end, height) && NextToken(pos, end, maxValue);
+    //exactly one whitespace character between the header and the samples
+    valid = valid && pos < end && isspace((unsigned char)*pos) && width > 1 && height > 1 && maxValue > 0 &&
+            maxValue < 65536;
+    if (!valid) {
+        std::cerr << path << " is not a binary PGM (P5) height raster" << std::endl;
+        file.Close();
+        return false;
+    }
+    pos++;
+
+    bytesPerSample = maxValue < 256 ? 1 : 2;
+    if ((size_t)(end - pos) < (size_t)width * height * bytesPerSample) {
+        std::cerr << "Height raster " << path << " is truncated" << std::endl;
+        file.Close();
+        return false;
+    }
+    samples = (const unsigned char*)pos;
+    cols = (int)width;
+    rows = (int)height;
+    return true;
+}
+
+double HeightRaster::Sample(int col, int row) const {
+    col = std::max(0, std::min(cols - 1, col));
+    row = std::max(0, std::min(rows - 1, row));
+    const unsigned char* sample = samples + ((size_t)row * cols + col) * bytesPerSample;
+    if (bytesPerSample == 1)
+        return sample[0];
+    return (sample[0] << 8) | sample[1];  //16 bit PGM is big endian
+}
+
+// -----------------------------------------------------------------------------
+// TiledTerrain
+// -----------------------------------------------------------------------------
+
+TiledTerrain::TiledTerrain(ChSystem& system, const TerrainSettings& settings) : system(system), settings(settings) {}
+
+TiledTerrain::~TiledTerrain() {
+    Clear();
+}
+
+bool TiledTerrain::Load(const std::string& path) {
+    Clear();
+    if (!raster.Open(path))
+        return false;
+    numTilesX = (raster.Cols() - 2) / settings.tileCells + 1;
+    numTilesZ = (raster.Rows() - 2) / settings.tileCells + 1;
+    checked = false;
+    return true;
+}
+
+double TiledTerrain::HeightAt(double x, double z) const {
+    double u = (x - settings.origin.x()) / settings.cellSize;
+    double v = (z - settings.origin.z()) / settings.cellSize;
+    u = std::max(0.0, std::min(u, raster.Cols() - 1.0));
+    v = std::max(0.0, std::min(v, raster.Rows() - 1.0));
+    int c = std::min((int)u, raster.Cols() - 2);
+    int r = std::min((int)v, raster.Rows() - 2);
+    double fu = u - c, fv = v - r;
+    double h = (1 - fu) * (1 - fv) * raster.Sample(c, r) + fu * (1 - fv) * raster.Sample(c + 1, r) +
+               (1 - fu) * fv * raster.Sample(c, r + 1) + fu * fv * raster.Sample(c + 1, r + 1);
+    return settings.origin.y() + h * settings.heightScale;
+}
+
+double TiledTerrain::TileDistance(int tileX, int tileZ, double x, double z) const {
+    double tileSize = settings.tileCells * settings.cellSize;
+    double minX = settings.origin.x() + tileX * tileSize;
+    double minZ = settings.origin.z() + tileZ * tileSize;
+    double dx = std::max(0.0, std::max(minX - x, x - (minX + tileSize)));
+    double dz = std::max(0.0, std::max(minZ - z, z - (minZ + tileSize)));
+    return sqrt(dx * dx + dz * dz);
+}
+
+std::shared_ptr<ChBody> TiledTerrain::BuildTile(int tileX, int tileZ) {
+    int col0 = tileX * settings.tileCells;
+    int row0 = tileZ * settings.tileCells;
+    int numCols = std::min(settings.tileCells, raster.Cols() - 1 - col0) + 1;  //vertices per side
+    int numRows = std::min(settings.tileCells, raster.Rows() - 1 - row0) + 1;
+
+    auto mesh = std::make_shared<geometry::ChTriangleMeshConnected>();
+    std::vector<ChVector<>>& vertices = mesh->getCoordsVertices();
+    std::vector<ChVector<int>>& triangles = mesh->getIndicesVertexes();
+    vertices.reserve((size_t)numCols * numRows);
+    triangles.reserve((size_t)(numCols - 1) * (numRows - 1) * 2);
+
+    for (int r = 0; r < numRows; r++)
+        for (int c = 0; c < numCols; c++)
+            vertices.push_back(ChVector<>(settings.origin.x() + (col0 + c) * settings.cellSize,
+                                          settings.origin.y() + raster.Sample(col0 + c, row0 + r) * settings.heightScale,
+                                          settings.origin.z() + (row0 + r) * settings.cellSize));
+
+    //two triangles per cell, wound so the normals point up (+Y)
+    for (int r = 0; r + 1 < numRows; r++) {
+        for (int c = 0; c + 1 < numCols; c++) {
+            int v00 = r * numCols + c;
+            int v10 = v00 + 1;            //+X
+            int v01 = v00 + numCols;      //+Z
+            int v11 = v01 + 1;
+            triangles.push_back(ChVector<int>(v00, v01, v10));
+            triangles.push_back(ChVector<int>(v10, v01, v11));
+        }
+    }
+
+    auto tile = std::make_shared<ChBody>();
+    tile->SetBodyFixed(true);
+    tile->SetName("terrain");
+    tile->GetCollisionModel()->ClearModel();
+    tile->GetCollisionModel()->AddTriangleMesh(mesh, true, false, VNULL, ChMatrix33<>(1), settings.meshThickness);
+    tile->GetCollisionModel()->BuildModel();
+    tile->SetCollide(true);
+
+    if (settings.visualization) {
+        auto shape = std::make_shared<ChTriangleMeshShape>();
+        shape->SetMesh(mesh);
+        tile->AddAsset(shape);
+        auto color = std::make_shared<ChColorAsset>();
+        color->SetColor(ChColor(0.45f, 0.4f, 0.3f));
+        tile->AddAsset(color);
+    }
+    return tile;
+}
+
+void TiledTerrain::Update(const ChVector<>& center) {
+    double tileSize = settings.tileCells * settings.cellSize;
+    if (numTilesX == 0 || (checked && (center - lastCenter).Length() < 0.25 * tileSize))
+        return;
+    checked = true;
+    lastCenter = center;
+
+    //evict first so the peak count is not inflated by tiles on their way out
+    for (auto it = tiles.begin(); it != tiles.end();) {
+        int tileX = (int)(it->first >> 32);
+        int tileZ = (int)(int32_t)(it->first & 0xffffffff);
+        if (TileDistance(tileX, tileZ, center.x(), center.z()) > settings.evictRadius) {
+            system.RemoveBody(it->second);
+            it = tiles.erase(it);
+            tilesEvicted++;
+        } else {
+            ++it;
+        }
+    }
+
+    int minX = std::max(0, (int)floor((center.x() - settings.loadRadius - settings.origin.x()) / tileSize));
+    int maxX = std::min(numTilesX - 1, (int)floor((center.x() + settings.loadRadius - settings.origin.x()) / tileSize));
+    int minZ = std::max(0, (int)floor((center.z() - settings.loadRadius - settings.origin.z()) / tileSize));
+    int maxZ = std::min(numTilesZ - 1, (int)floor((center.z() + settings.loadRadius - settings.origin.z()) / tileSize));
+    for (int tileX = minX; tileX <= maxX; tileX++) {
+        for (int tileZ = minZ; tileZ <= maxZ; tileZ++) {
+            if (TileDistance(tileX, tileZ, center.x(), center.z()) > settings.loadRadius ||
+                tiles.count(TileKey(tileX, tileZ)))
+                continue;
+            auto tile = BuildTile(tileX, tileZ);
+            system.Add(tile);
+            tiles[TileKey(tileX, tileZ)] = tile;
+            tilesLoaded++;
+        }
+    }
+    peakTiles = std::max(peakTiles, (int)tiles.size());
+}
+
+void TiledTerrain::Clear() {
+    for (auto& tile : tiles)
+        system.RemoveBody(tile.second);
+    tiles.clear();
+    checked = false;
+}
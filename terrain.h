@@ -0,0 +1,110 @@
+// =============================================================================
+// Tiled heightfield terrain.
+//
+// The height raster (binary PGM, 8 or 16 bit, e.g. a DEM exported with
+// gdal_translate -of PNM) is memory mapped and only read where tiles are
+// built. The terrain is split into square tiles of tileCells x tileCells
+// cells; each tile is a fixed body with a static triangle mesh collision
+// model. Update() keeps the tiles within loadRadius of the rover in the
+// system and removes the ones farther than evictRadius, so kilometer scale
+// terrain costs no more broadphase work or memory than the patch around the
+// rover.
+//
+// Raster column c runs along +X and row r along +Z; sample (0, 0) is at
+// origin. Heights are origin.y + value * heightScale.
+// =============================================================================
+
+#ifndef TERRAIN_H
+#define TERRAIN_H
+
+#include "chrono/physics/ChSystem.h"
+#include "chrono/physics/ChBody.h"
+
+#include "mapped_file.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+struct TerrainSettings {
+    double cellSize = 0.1;       //meters between raster samples
+    double heightScale = 0.001;  //meters per raster unit
+    chrono::ChVector<> origin;   //world position of raster sample (0, 0)
+
+    int tileCells = 64;          //cells per tile side
+    double loadRadius = 8;       //tiles closer than this to the rover are loaded ...
+    double evictRadius = 12;     //... and removed again once farther than this
+
+    double meshThickness = 0.01; //sphere-swept radius of the collision mesh, for robust contacts
+    bool visualization = false;
+};
+
+//memory mapped binary PGM raster
+class HeightRaster {
+  public:
+    bool Open(const std::string& path);
+
+    int Cols() const { return cols; }
+    int Rows() const { return rows; }
+    //raw sample, clamped to the raster
+    double Sample(int col, int row) const;
+
+  private:
+    MappedFile file;
+    const unsigned char* samples = nullptr;
+    int cols = 0;
+    int rows = 0;
+    int bytesPerSample = 1;
+};
+
+class TiledTerrain {
+  public:
+    TiledTerrain(chrono::ChSystem& system, const TerrainSettings& settings);
+    ~TiledTerrain();
+
+    bool Load(const std::string& path);
+
+    //move the raster, e.g. to put the rover's start point at a given height. Only before the first Update().
+    void SetOrigin(const chrono::ChVector<>& origin) { settings.origin = origin; }
+
+    //bilinear terrain height below (x, z)
+    double HeightAt(double x, double z) const;
+    //world size of the raster
+    double SizeX() const { return (raster.Cols() - 1) * settings.cellSize; }
+    double SizeZ() const { return (raster.Rows() - 1) * settings.cellSize; }
+
+    //load tiles near center and evict far ones. Cheap to call every step: tiles are only checked
+    //again after center moved a quarter tile.
+    void Update(const chrono::ChVector<>& center);
+
+    //remove every loaded tile from the system
+    void Clear();
+
+    int NumLoadedTiles() const { return (int)tiles.size(); }
+    int PeakLoadedTiles() const { return peakTiles; }
+    long TilesLoaded() const { return tilesLoaded; }
+    long TilesEvicted() const { return tilesEvicted; }
+
+  private:
+    std::shared_ptr<chrono::ChBody> BuildTile(int tileX, int tileZ);
+    //distance from (x, z) to the tile's footprint
+    double TileDistance(int tileX, int tileZ, double x, double z) const;
+    static int64_t TileKey(int tileX, int tileZ) { return ((int64_t)tileX << 32) | (uint32_t)tileZ; }
+
+    chrono::ChSystem& system;
+    TerrainSettings settings;
+    HeightRaster raster;
+    int numTilesX = 0;
+    int numTilesZ = 0;
+
+    std::unordered_map<int64_t, std::shared_ptr<chrono::ChBody>> tiles;
+    chrono::ChVector<> lastCenter;  //where the tiles were last checked
+    bool checked = false;
+
+    int peakTiles = 0;
+    long tilesLoaded = 0;
+    long tilesEvicted = 0;
+};
+
+#endif
@@ -0,0 +1,129 @@
+// =============================================================================
+// Work-stealing thread pool for batch runs.
+//
+// Every worker owns a task deque. Workers take from the back of their own
+// deque and, when it is empty, steal from the front of the others, so a few
+// long simulations do not leave the rest of the cores idle.
+// =============================================================================
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+  public:
+    //numThreads = 0 -> one worker per hardware thread
+    explicit WorkStealingPool(unsigned numThreads = 0) : queued(0), pending(0), nextQueue(0), stopping(false) {
+        if (numThreads == 0)
+            numThreads = std::thread::hardware_concurrency();
+        if (numThreads == 0)
+            numThreads = 1;
+        for (unsigned i = 0; i < numThreads; i++)
+            queues.emplace_back(new Queue);
+        for (unsigned i = 0; i < numThreads; i++)
+            workers.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned Size() const { return (unsigned)workers.size(); }
+
+    //queue a task, spreading tasks round-robin over the worker deques
+    void Submit(std::function<void()> task) {
+        pending.fetch_add(1);
+        Queue& queue = *queues[nextQueue.fetch_add(1) % queues.size()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        queued.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+        }
+        wake.notify_one();
+    }
+
+    //block until every submitted task has finished
+    void Wait() {
+        std::unique_lock<std::mutex> lock(idleMutex);
+        done.wait(lock, [this] { return pending.load() == 0; });
+    }
+
+  private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    //own deque first (newest task), then steal the oldest task of another worker
+    bool TryPop(unsigned self, std::function<void()>& task) {
+        for (size_t n = 0; n < queues.size(); n++) {
+            Queue& queue = *queues[(self + n) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+            if (n == 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            queued.fetch_sub(1);
+            return true;
+        }
+        return false;
+    }
+
+    void WorkerLoop(unsigned self) {
+        while (true) {
+            std::function<void()> task;
+            if (TryPop(self, task)) {
+                task();
+                if (pending.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(idleMutex);
+                    done.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(idleMutex);
+            wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+            if (stopping && queued.load() == 0)
+                return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex idleMutex;
+    std::condition_variable wake;  //tasks were queued or the pool is stopping
+    std::condition_variable done;  //pending dropped to zero
+
+    std::atomic<size_t> queued;   //tasks sitting in a deque
+    std::atomic<size_t> pending;  //tasks submitted but not finished
+    std::atomic<unsigned> nextQueue;
+    bool stopping;
+};
+
+#endif
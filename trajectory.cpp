@@ -0,0 +1,145 @@
+// =============================================================================
+// Binary trajectory files -> see trajectory.h for the layout.
+// =============================================================================
+
+#include "trajectory.h"
+
+#include <cstring>
+#include <iostream>
+
+using namespace chrono;
+
+static const char trajectoryMagic[8] = "ROVTRAJ";
+static const uint32_t trajectoryVersion = 1;
+static const uint64_t trajectoryAlignment = 4096;  //columns start on a page boundary
+
+// -----------------------------------------------------------------------------
+// TrajectoryWriter
+// -----------------------------------------------------------------------------
+
+bool TrajectoryWriter::Open(const std::string& path, ChSystem& sys, double stepSize, uint64_t maxSamples) {
+    Close();
+    system = &sys;
+    bodies.assign(sys.Get_bodylist().begin(), sys.Get_bodylist().end());
+
+    //name table -> unnamed bodies get their index in the body list
+    std::string nameTable;
+    for (size_t b = 0; b < bodies.size(); b++) {
+        std::string name = bodies[b]->GetName();
+        if (name.empty())
+            name = "body" + std::to_string(b);
+        nameTable += name;
+        nameTable += '\0';
+    }
+
+    uint64_t dataOffset = sizeof(TrajectoryHeader) + nameTable.size();
+    dataOffset = (dataOffset + trajectoryAlignment - 1) / trajectoryAlignment * trajectoryAlignment;
+    uint64_t numColumns = 1 + bodies.size() * TRAJ_NUM_CHANNELS;
+    uint64_t fileSize = dataOffset + numColumns * maxSamples * sizeof(double);
+
+    if (maxSamples == 0 || !file.Create(path, (size_t)fileSize)) {
+        std::cerr << "Could not create trajectory file " << path << std::endl;
+        system = nullptr;
+        bodies.clear();
+        return false;
+    }
+
+    header = (TrajectoryHeader*)file.Data();
+    memset(header, 0, sizeof(TrajectoryHeader));
+    memcpy(header->magic, trajectoryMagic, sizeof(header->magic));
+    header->version = trajectoryVersion;
+    header->numBodies = (uint32_t)bodies.size();
+    header->numChannels = TRAJ_NUM_CHANNELS;
+    header->nameBytes = (uint32_t)nameTable.size();
+    header->stepSize = stepSize;
+    header->numSamples = 0;
+    header->capacity = maxSamples;
+    header->dataOffset = dataOffset;
+    memcpy(file.Data() + sizeof(TrajectoryHeader), nameTable.data(), nameTable.size());
+
+    columns = (double*)(file.Data() + dataOffset);
+    return true;
+}
+
+bool TrajectoryWriter::Append() {
+    if (!header || header->numSamples >= header->capacity)
+        return false;
+
+    uint64_t capacity = header->capacity;
+    uint64_t n = header->numSamples;
+    columns[n] = system->GetChTime();
+
+    double* column = columns + capacity + n;  //body 0, channel 0
+    for (const auto& body : bodies) {
+        const ChVector<>& pos = body->GetPos();
+        const ChQuaternion<>& rot = body->GetRot();
+        const ChVector<>& vel = body->GetPos_dt();
+        ChVector<> wvel = body->GetWvel_par();
+        double values[TRAJ_NUM_CHANNELS] = { pos.x(),  pos.y(),  pos.z(),  rot.e0(), rot.e1(), rot.e2(), rot.e3(),
+                                             vel.x(),  vel.y(),  vel.z(),  wvel.x(), wvel.y(), wvel.z() };
+        for (int c = 0; c < TRAJ_NUM_CHANNELS; c++, column += capacity)
+            *column = values[c];
+    }
+
+    header->numSamples = n + 1;
+    return true;
+}
+
+void TrajectoryWriter::Close() {
+    file.Close();
+    header = nullptr;
+    columns = nullptr;
+    system = nullptr;
+    bodies.clear();
+}
+
+// -----------------------------------------------------------------------------
+// TrajectoryReader
+// -----------------------------------------------------------------------------
+
+bool TrajectoryReader::Open(const std::string& path) {
+    Close();
+    if (!file.OpenRead(path)) {
+        std::cerr << "Could not open trajectory file " << path << std::endl;
+        return false;
+    }
+
+    const TrajectoryHeader* h = (const TrajectoryHeader*)file.Data();
+    bool valid = file.Size() >= sizeof(TrajectoryHeader) && memcmp(h->magic, trajectoryMagic, sizeof(h->magic)) == 0 &&
+                 h->version == trajectoryVersion && h->numSamples <= h->capacity &&
+                 sizeof(TrajectoryHeader) + (uint64_t)h->nameBytes <= h->dataOffset &&
+                 h->dataOffset + (1 + (uint64_t)h->numBodies * h->numChannels) * h->capacity * sizeof(double) <= file.Size();
+    if (!valid) {
+        std::cerr << path << " is not a trajectory file" << std::endl;
+        file.Close();
+        return false;
+    }
+
+    header = h;
+    columns = (const double*)(file.Data() + h->dataOffset);
+
+    const char* name = file.Data() + sizeof(TrajectoryHeader);
+    const char* end = name + h->nameBytes;
+    while (name < end && names.size() < h->numBodies) {
+        size_t length = strnlen(name, end - name);
+        names.emplace_back(name, length);
+        name += length + 1;
+    }
+    while (names.size() < h->numBodies)
+        names.push_back("body" + std::to_string(names.size()));
+    return true;
+}
+
+void TrajectoryReader::Close() {
+    file.Close();
+    header = nullptr;
+    columns = nullptr;
+    names.clear();
+}
+
+int TrajectoryReader::FindBody(const std::string& name) const {
+    for (size_t b = 0; b < names.size(); b++)
+        if (names[b] == name)
+            return (int)b;
+    return -1;
+}
@@ -0,0 +1,94 @@
+// =============================================================================
+// Binary trajectory files.
+//
+// Per-step state of every body in a system (position, rotation quaternion,
+// linear and angular velocity) stored column by column:
+//
+//   [TrajectoryHeader][body names, '\0' separated][padding to 4096]
+//   [time column][body 0 channel 0 column][body 0 channel 1 column]...
+//
+// Every column holds `capacity` doubles, so the column of any body/channel is
+// at a fixed offset and stride and can be used straight from a memory map.
+// Only the first numSamples entries of each column are valid.
+// =============================================================================
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include "chrono/physics/ChSystem.h"
+
+#include "mapped_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+//per-body channels in column order
+enum TrajectoryChannel {
+    TRAJ_POS_X, TRAJ_POS_Y, TRAJ_POS_Z,
+    TRAJ_ROT_E0, TRAJ_ROT_E1, TRAJ_ROT_E2, TRAJ_ROT_E3,
+    TRAJ_VEL_X, TRAJ_VEL_Y, TRAJ_VEL_Z,
+    TRAJ_WVEL_X, TRAJ_WVEL_Y, TRAJ_WVEL_Z,  //angular velocity in the absolute frame
+    TRAJ_NUM_CHANNELS
+};
+
+struct TrajectoryHeader {
+    char magic[8];           //"ROVTRAJ"
+    uint32_t version;
+    uint32_t numBodies;
+    uint32_t numChannels;    //per body
+    uint32_t nameBytes;      //size of the name table that follows the header
+    double stepSize;         //nominal step size of the run
+    uint64_t numSamples;     //valid samples, kept up to date while writing
+    uint64_t capacity;       //samples per column
+    uint64_t dataOffset;     //byte offset of the time column
+};
+
+class TrajectoryWriter {
+  public:
+    //map the file and record the bodies currently in the system. maxSamples bounds the run
+    //(e.g. duration / step size + 1). Returns false if the file cannot be created.
+    bool Open(const std::string& path, chrono::ChSystem& system, double stepSize, uint64_t maxSamples);
+
+    //sample every recorded body at the current system time. Returns false once the file is full.
+    bool Append();
+
+    void Close();
+
+    uint64_t NumSamples() const { return header ? header->numSamples : 0; }
+
+  private:
+    MappedFile file;
+    TrajectoryHeader* header = nullptr;
+    double* columns = nullptr;
+    chrono::ChSystem* system = nullptr;
+    std::vector<std::shared_ptr<chrono::ChBody>> bodies;
+};
+
+class TrajectoryReader {
+  public:
+    bool Open(const std::string& path);
+    void Close();
+
+    uint64_t NumSamples() const { return header->numSamples; }
+    uint32_t NumBodies() const { return header->numBodies; }
+    double StepSize() const { return header->stepSize; }
+    const std::vector<std::string>& BodyNames() const { return names; }
+    int FindBody(const std::string& name) const;
+
+    //zero-copy views into the mapped file, NumSamples() entries each
+    const double* Time() const { return columns; }
+    const double* Column(uint32_t body, TrajectoryChannel channel) const {
+        return columns + (1 + (size_t)body * header->numChannels + channel) * header->capacity;
+    }
+
+  private:
+    MappedFile file;
+    const TrajectoryHeader* header = nullptr;
+    const double* columns = nullptr;
+    std::vector<std::string> names;
+};
+
+#endif
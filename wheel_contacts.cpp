@@ -0,0 +1,141 @@
+#include "wheel_contacts.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace chrono;
+
+class WheelContacts::ContactReporter : public ChContactContainer::ReportContactCallback {
+  public:
+    explicit ContactReporter(WheelContacts& contacts) : contacts(contacts) {}
+
+    virtual bool OnReportContact(const ChVector<>& pA,
+                                 const ChVector<>& pB,
+                                 const ChMatrix33<>& plane_coord,
+                                 const double& distance,
+                                 const double& eff_radius,
+                                 const ChVector<>& react_forces,
+                                 const ChVector<>& react_torques,
+                                 ChContactable* contactobjA,
+                                 ChContactable* contactobjB) override {
+        //reaction in the contact plane frame -> x along the normal, y and z tangential
+        double normal = std::abs(react_forces.x());
+        double tangential = std::sqrt(react_forces.y() * react_forces.y() + react_forces.z() * react_forces.z());
+        for (int w = 0; w < contacts.numWheels; w++) {
+            if (contacts.wheelContactables[w] == contactobjA || contacts.wheelContactables[w] == contactobjB) {
+                contacts.current.normalForce[w] += (float)normal;
+                contacts.current.tangentialForce[w] += (float)tangential;
+                contacts.current.contactCount[w]++;
+            }
+        }
+        return true;  //keep going
+    }
+
+  private:
+    WheelContacts& contacts;
+};
+
+WheelContacts::WheelContacts(ChSystem& system, const RoverModel& rover, const WheelContactSettings& settings)
+    : system(system), rover(rover), settings(settings), numWheels((int)rover.wheels.size()) {
+    for (const auto& wheel : rover.wheels)
+        wheelContactables.push_back(wheel.get());
+    reporter.reset(new ContactReporter(*this));
+    current.normalForce.assign(numWheels, 0.0f);
+    current.tangentialForce.assign(numWheels, 0.0f);
+    current.slip.assign(numWheels, 0.0f);
+    current.contactCount.assign(numWheels, 0);
+    summaries.resize(numWheels);
+}
+
+WheelContacts::~WheelContacts() {}
+
+void WheelContacts::Reserve(size_t numSteps) {
+    if (!settings.keepHistory)
+        return;
+    times.reserve(numSteps);
+    history.normalForce.reserve(numSteps * numWheels);
+    history.tangentialForce.reserve(numSteps * numWheels);
+    history.slip.reserve(numSteps * numWheels);
+    history.contactCount.reserve(numSteps * numWheels);
+}
+
+void WheelContacts::Record() {
+    std::fill(current.normalForce.begin(), current.normalForce.end(), 0.0f);
+    std::fill(current.tangentialForce.begin(), current.tangentialForce.end(), 0.0f);
+    std::fill(current.contactCount.begin(), current.contactCount.end(), (uint16_t)0);
+    if (system.GetContactContainer())
+        system.GetContactContainer()->ReportAllContacts(reporter.get());
+
+    ChVector<> up = -system.Get_G_acc();
+    up = up.Length() > 0 ? up * (1.0 / up.Length()) : ChVector<>(0, 1, 0);
+    for (int w = 0; w < numWheels; w++) {
+        const ChBody& wheel = *rover.wheels[w];
+        //cylinder axis is the wheel's local Y. Rolling without slip moves the hub by spin x (radius * up).
+        ChVector<> axle = wheel.GetRot().GetYaxis();
+        ChVector<> forward = axle % up;
+        double slip = 0;
+        if (forward.Length() > 1e-6) {
+            forward = forward * (1.0 / forward.Length());
+            double rolling = (wheel.GetWvel_par() ^ axle) * rover.wheelRadius;
+            double hub = wheel.GetPos_dt() ^ forward;
+            double scale = std::max(std::abs(rolling), std::abs(hub));
+            if (scale >= settings.minSlipSpeed)
+                slip = (rolling - hub) / scale;
+        }
+        current.slip[w] = (float)slip;
+
+        WheelContactSummary& summary = summaries[w];
+        summary.normalForce.Add(current.normalForce[w]);
+        summary.tangentialForce.Add(current.tangentialForce[w]);
+        if (current.contactCount[w] > 0) {
+            summary.slip.Add(slip);
+            summary.stepsInContact++;
+        }
+    }
+
+    if (settings.keepHistory) {
+        times.push_back(system.GetChTime());
+        history.normalForce.insert(history.normalForce.end(), current.normalForce.begin(), current.normalForce.end());
+        history.tangentialForce.insert(history.tangentialForce.end(), current.tangentialForce.begin(),
+                                       current.tangentialForce.end());
+        history.slip.insert(history.slip.end(), current.slip.begin(), current.slip.end());
+        history.contactCount.insert(history.contactCount.end(), current.contactCount.begin(),
+                                    current.contactCount.end());
+    }
+    numSteps++;
+}
+
+void WheelContacts::WriteCsv(std::ostream& out) const {
+    out << "time";
+    for (int w = 0; w < numWheels; w++)
+        out << ",normal_" << w << ",tangential_" << w << ",contacts_" << w << ",slip_" << w;
+    out << "\n";
+    for (size_t s = 0; s < times.size(); s++) {
+        out << times[s];
+        for (int w = 0; w < numWheels; w++) {
+            size_t i = s * numWheels + w;
+            out << ',' << history.normalForce[i] << ',' << history.tangentialForce[i] << ','
+                << history.contactCount[i] << ',' << history.slip[i];
+        }
+        out << "\n";
+    }
+}
+
+void WheelContacts::PrintSummary(std::ostream& out) const {
+    out << "WHEEL CONTACTS: " << numSteps << " steps, " << numWheels << " wheels (mean / max)" << std::endl;
+    double totalLoad = 0;
+    for (const WheelContactSummary& summary : summaries)
+        totalLoad += summary.normalForce.Mean();
+    for (int w = 0; w < numWheels; w++) {
+        const WheelContactSummary& summary = summaries[w];
+        out << "WHEEL " << w << (w < rover.numLeftWheels ? " (left)" : " (right)") << ": load "
+            << summary.normalForce.Mean() << " / " << summary.normalForce.Max() << " N, traction "
+            << summary.tangentialForce.Mean() << " / " << summary.tangentialForce.Max() << " N, in contact "
+            << (numSteps > 0 ? 100.0 * summary.stepsInContact / numSteps : 0) << "%, slip "
+            << summary.slip.Mean() << " (rms " << summary.slip.Rms() << ")" << std::endl;
+    }
+    out << "WHEEL LOAD SHARE:";
+    for (const WheelContactSummary& summary : summaries)
+        out << " " << (totalLoad > 0 ? 100 * summary.normalForce.Mean() / totalLoad : 0) << "%";
+    out << std::endl;
+}
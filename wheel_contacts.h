@@ -0,0 +1,111 @@
+// =============================================================================
+// Per-wheel contact loads and slip.
+//
+// After every step, walks the system's contact list once and adds every
+// contact touching a rover wheel to that wheel: normal force, tangential
+// (traction) force and the number of contact points. Forces are the
+// magnitudes of the contact reactions in their contact plane, so they are
+// the same whichever body Chrono lists first. Slip ratio compares the
+// wheel's rolling speed (spin about its axle times wheelRadius) with the
+// speed of its hub along the rolling direction:
+//     slip = (rolling - hub) / max(|rolling|, |hub|)
+// -> 0 rolling freely, > 0 spinning (driving), < 0 skidding (1 = spinning in
+// place, -1 = locked and sliding), 0 while both are below minSlipSpeed. The
+// hub speed is used rather than the chassis speed so the outer wheels in a
+// turn do not read as spinning.
+//
+// With keepHistory every step is stored in preallocated columnar arrays,
+// numWheels entries per step. Either way per-wheel running statistics are
+// kept, so sweeps can leave it on at the cost of one pass over the contacts.
+// =============================================================================
+
+#ifndef WHEEL_CONTACTS_H
+#define WHEEL_CONTACTS_H
+
+#include "chrono/physics/ChSystem.h"
+
+#include "rover_model.h"
+#include "streaming_stats.h"
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+struct WheelContactSettings {
+    bool keepHistory = true;     //store every step, not only the statistics
+    double minSlipSpeed = 0.01;  //m/s, slip is 0 below it
+};
+
+//running statistics of one wheel
+struct WheelContactSummary {
+    RunningStats normalForce;      //N, every step
+    RunningStats tangentialForce;  //N, every step
+    RunningStats slip;             //steps in contact only
+    size_t stepsInContact = 0;
+};
+
+class WheelContacts {
+  public:
+    WheelContacts(chrono::ChSystem& system, const RoverModel& rover,
+                  const WheelContactSettings& settings = WheelContactSettings());
+    ~WheelContacts();
+
+    WheelContacts(const WheelContacts&) = delete;
+    WheelContacts& operator=(const WheelContacts&) = delete;
+
+    //preallocate the history for the expected number of steps
+    void Reserve(size_t numSteps);
+
+    //call after every DoStepDynamics -> stores the loads and slip of that step
+    void Record();
+
+    int NumWheels() const { return numWheels; }
+    size_t NumSteps() const { return numSteps; }
+
+    //latest step, one entry per wheel in RoverModel order
+    const float* LastNormalForce() const { return current.normalForce.data(); }
+    const float* LastTangentialForce() const { return current.tangentialForce.data(); }
+    const float* LastSlip() const { return current.slip.data(); }
+    const uint16_t* LastContactCount() const { return current.contactCount.data(); }
+
+    //history (keepHistory only): numWheels entries per step, step after step
+    const std::vector<double>& Times() const { return times; }
+    const std::vector<float>& NormalForce() const { return history.normalForce; }
+    const std::vector<float>& TangentialForce() const { return history.tangentialForce; }
+    const std::vector<float>& Slip() const { return history.slip; }
+    const std::vector<uint16_t>& ContactCount() const { return history.contactCount; }
+
+    const WheelContactSummary& Summary(int wheel) const { return summaries[wheel]; }
+
+    //time, then normal, tangential, contacts and slip of every wheel per row (keepHistory only)
+    void WriteCsv(std::ostream& out) const;
+
+    //per wheel mean/max load, traction, contact time, slip and each wheel's share of the load
+    void PrintSummary(std::ostream& out) const;
+
+  private:
+    class ContactReporter;
+
+    struct Columns {
+        std::vector<float> normalForce;
+        std::vector<float> tangentialForce;
+        std::vector<float> slip;
+        std::vector<uint16_t> contactCount;
+    };
+
+    chrono::ChSystem& system;
+    const RoverModel& rover;
+    WheelContactSettings settings;
+    int numWheels;
+    std::vector<const chrono::ChContactable*> wheelContactables;
+    std::unique_ptr<ContactReporter> reporter;
+
+    Columns current;  //one entry per wheel
+    Columns history;
+    std::vector<double> times;
+    size_t numSteps = 0;
+    std::vector<WheelContactSummary> summaries;
+};
+
+#endif